@@ -0,0 +1,178 @@
+#pragma once
+
+/*
+https://learnopengl.com/Getting-started/Camera
+*/
+#include <application.h>
+#include <indirectRenderer.h>
+#include <mesh.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class CameraRotateAroundScene : public Application
+{
+    Shader* ourShader;
+    unsigned int VAO;
+    unsigned int cubeDraw;
+    MeshBuffer cube;
+    // the floor is a second mesh; with vertex pulling it shares the cubes' program and goes out in
+    // their multi-draw, otherwise it needs its own VAO, program and draw
+    Shader* floorShader;
+    unsigned int floorVAO;
+    unsigned int floorDraw;
+    MeshBuffer floor;
+    bool batched = false;
+    IndirectRenderer instances;
+    // the meshBuffers() generation the draws' first indices were taken in
+    unsigned long long meshGeneration = 0;
+    unsigned int texture1;
+    unsigned int texture2;
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    void init() override
+    {
+        // the camera orbits on its own, only Escape is handled
+        cameraControls = false;
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+        floor.upload(floorMesh());
+
+        // build and compile our shader zprogram
+        // ------------------------------------
+        ourShader = loadShader("../camera-rotate-around-scene/shader.vs", "../camera-rotate-around-scene/shader.fs", cube.shaderDecode());
+        // the same program when both meshes are pulled: the decode doesn't depend on the mesh
+        floorShader = loadShader("../camera-rotate-around-scene/shader.vs", "../camera-rotate-around-scene/shader.fs", floor.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_TEXCOORD);
+        floorVAO = floor.createVertexArray(VERTEX_POSITION | VERTEX_TEXCOORD);
+        batched = cube.batchesWith(floor);
+        // per-object model matrices, culled against the view frustum on the GPU
+        cubeDraw = instances.addDraw(cube.indexCount(), cube.firstIndex(), 0, boundingSphere(cubeMesh()));
+        floorDraw = instances.addDraw(floor.indexCount(), floor.firstIndex(), 0, boundingSphere(floorMesh()));
+        instances.attach(VAO);
+        if (!batched) {
+            instances.attach(floorVAO);
+        }
+        meshGeneration = meshBuffers().generation();
+        // uploaded once: each cube rests at its position and the vertex shader turns it
+        for (unsigned int i = 0; i < 10; i++)
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), cubePositions[i]);
+            float angle = 20.0f * (i + 1);
+            instances.add(model, cubeDraw, 0, glm::vec4(glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)), glm::radians(angle)));
+        }
+        instances.add(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -4.0f, 0.0f)), floorDraw);
+
+
+        // load and create a texture 
+        // -------------------------
+        texture1 = loadTexture("../resources/textures/container.jpg");
+        texture2 = loadTexture("../resources/textures/awesomeface.png");
+
+        for (Shader* shader : { ourShader, floorShader }) {
+            shader->use();
+            shader->setInt("texture", 0);
+            shader->setInt("texture2", 1);
+        }
+    }
+
+    // a floor under the cubes: the cube flattened and widened, its texture repeating
+    static const Mesh& floorMesh()
+    {
+        static const Mesh mesh = [] {
+            Mesh floor = cubeMesh();
+            for (size_t v = 0; v < floor.vertexCount(); v++) {
+                float* vertex = &floor.vertices[v * floor.floatsPerVertex];
+                vertex[0] *= 20.0f;
+                vertex[1] *= 0.2f;
+                vertex[2] *= 20.0f;
+                vertex[6] *= 8.0f;
+                vertex[7] *= 8.0f;
+            }
+            return floor;
+        }();
+        return mesh;
+    }
+
+    void setUniforms(Shader* shader, const glm::mat4& view, const glm::mat4& projection)
+    {
+        shader->use();
+        glUniform1d(glGetUniformLocation(shader->ID, "time"), renderTime());
+        unsigned int viewLoc = glGetUniformLocation(shader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(shader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture1);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2);
+
+        const float radius = 10.0f;
+        float camX = sin(renderTime()) * radius;
+        float camZ = cos(renderTime()) * radius;
+        glm::mat4 view = glm::lookAt(glm::vec3(camX, 0.0, camZ), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
+        glm::mat4 projection = projectionMatrix();
+
+        // the runner compacted the mesh buffers: our indices may have moved, and apart
+        if (meshGeneration != meshBuffers().generation()) {
+            instances.setFirstIndex(cubeDraw, cube.firstIndex());
+            instances.setFirstIndex(floorDraw, floor.firstIndex());
+            if (batched && !cube.batchesWith(floor)) {
+                batched = false;
+                instances.attach(floorVAO);
+            }
+            meshGeneration = meshBuffers().generation();
+        }
+
+        // the GPU decides which objects are in view and draws them with indirect calls; no per-object work here
+        instances.cull(projection * view);
+
+        // render container
+        setUniforms(ourShader, view, projection);
+        if (batched) {
+            // the cubes and the floor in one draw call
+            instances.draw(VAO, GL_TRIANGLES, cube.indexType());
+            return;
+        }
+        instances.draw(VAO, GL_TRIANGLES, cube.indexType(), cubeDraw, 1);
+        setUniforms(floorShader, view, projection);
+        instances.draw(floorVAO, GL_TRIANGLES, floor.indexType(), floorDraw, 1);
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteVertexArrays(1, &floorVAO);
+        cube.destroy();
+        floor.destroy();
+        instances.destroy();
+    }
+};
@@ -1,15 +1,33 @@
 #version 430 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+// the cube at rest, turned by aSpin first (see IndirectRenderer::add)
+layout (location = 3) in mat4 aModel;
+// unit axis in xyz, radians per second in w
+layout (location = 13) in vec4 aSpin;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+// seconds; double so the wrapped angle doesn't lose the step after a long run (see wrappedAngle)
+uniform double time;
+
+// rotation by `angle` about the unit `axis`, as glm::rotate builds it
+mat3 spinMatrix(vec3 axis, float angle)
+{
+    float c = cos(angle);
+    float s = sin(angle);
+    vec3 t = (1.0 - c) * axis;
+    return mat3(
+        c + t.x * axis.x,          t.x * axis.y + s * axis.z, t.x * axis.z - s * axis.y,
+        t.y * axis.x - s * axis.z, c + t.y * axis.y,          t.y * axis.z + s * axis.x,
+        t.z * axis.x + s * axis.y, t.z * axis.y - s * axis.x, c + t.z * axis.z);
+}
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
-}
\ No newline at end of file
+    float angle = float(mod(double(aSpin.w) * time, 6.283185307179586LF));
+    gl_Position = projection * view * aModel * vec4(spinMatrix(aSpin.xyz, angle) * decodePosition(aPos), 1.0);
+    TexCoord = decodeTexCoord(aTexCoord);
+}
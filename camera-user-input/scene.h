@@ -0,0 +1,106 @@
+#pragma once
+
+/*
+https://learnopengl.com/Getting-started/Camera
+*/
+#include <application.h>
+#include <mesh.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class CameraUserInput : public Application
+{
+    Shader* ourShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    unsigned int texture;
+    unsigned int texture2;
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader zprogram
+        // ------------------------------------
+        ourShader = loadShader("../camera-user-input/shader.vs", "../camera-user-input/shader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_TEXCOORD);
+
+
+        // load and create a texture 
+        // -------------------------
+        texture = loadTexture("../resources/textures/container.jpg");
+        texture2 = loadTexture("../resources/textures/awesomeface.png", true);
+
+        ourShader->use();
+        ourShader->setInt("texture", 0);
+        ourShader->setInt("texture2", 1);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix(camera.Zoom);
+
+        // render container
+        ourShader->use();
+        unsigned int modelLoc = glGetUniformLocation(ourShader->ID, "model");
+
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        glBindVertexArray(VAO);
+
+        // transformations
+        for (unsigned int i = 0; i < 10; i++)
+        {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, cubePositions[i]);
+            float angle = 20.0f * (i + 1);
+            model = glm::rotate(model, wrappedAngle(renderTime(), glm::radians((double)angle)), glm::vec3(1.0f, 0.3f, 0.5f));
+            model = glm::scale(model, glm::vec3(1.1f, 1.1f, 1.1f));
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+
+            glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+        }
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+    }
+};
@@ -10,6 +10,6 @@ uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
+    gl_Position = projection * view * model * vec4(decodePosition(aPos), 1.0);
+    TexCoord = decodeTexCoord(aTexCoord);
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+https://learnopengl.com/Getting-started/Coordinate-Systems
+*/
+#include <application.h>
+#include <instancedRenderer.h>
+#include <mesh.h>
+#include <transformSystem.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class CubeMany : public Application
+{
+    Shader* ourShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    InstancedRenderer cubeInstances;
+    unsigned int texture;
+    unsigned int texture2;
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    Transform previousCubes[10];
+    Transform currentCubes[10];
+    // the interpolated cubes, composed into the instance stream in one batch
+    TransformSystem transforms;
+
+    void init() override
+    {
+        // the view is fixed, only Escape is handled
+        cameraControls = false;
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader zprogram
+        // ------------------------------------
+        ourShader = loadShader("../cube-many/shader.vs", "../cube-many/shader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_TEXCOORD);
+        // per-cube model matrices
+        cubeInstances.attach(VAO, frameData);
+
+
+        // load and create a texture 
+        // -------------------------
+        texture = loadTexture("../resources/textures/container.jpg");
+        texture2 = loadTexture("../resources/textures/awesomeface.png", true);
+
+        ourShader->use();
+        ourShader->setInt("texture", 0);
+        ourShader->setInt("texture2", 1);
+
+        for (unsigned int i = 0; i < 10; i++) {
+            currentCubes[i].position = cubePositions[i];
+            previousCubes[i] = currentCubes[i];
+            transforms.add(currentCubes[i]);
+        }
+    }
+
+    void update(double step) override
+    {
+        for (unsigned int i = 0; i < 10; i++) {
+            previousCubes[i] = currentCubes[i];
+            float angle = 20.0f * (i + 1);
+            currentCubes[i].rotation = glm::angleAxis(wrappedAngle(frameLoop.simulationTime(), glm::radians((double)angle)), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)));
+        }
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2);
+
+        glm::mat4 view = glm::mat4(1.0f);
+        // note that we're translating the scene in the reverse direction of where we want to move
+        view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
+        glm::mat4 projection = projectionMatrix();
+
+        // render container
+        ourShader->use();
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+        // transformations, all cubes go out in one instanced draw
+        for (unsigned int i = 0; i < 10; i++)
+        {
+            transforms.set(i, interpolate(previousCubes[i], currentCubes[i], alpha));
+        }
+        transforms.write(cubeInstances.map(transforms.size()));
+        cubeInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+        cubeInstances.destroy();
+    }
+};
@@ -1,15 +1,15 @@
 #version 430 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 3) in mat4 aModel;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
+    gl_Position = projection * view * aModel * vec4(decodePosition(aPos), 1.0);
+    TexCoord = decodeTexCoord(aTexCoord);
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+https://learnopengl.com/Getting-started/Coordinate-Systems
+*/
+#include <application.h>
+#include <mesh.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class Cube : public Application
+{
+    Shader* ourShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    unsigned int texture;
+    unsigned int texture2;
+
+    void init() override
+    {
+        // the view is fixed, only Escape is handled
+        cameraControls = false;
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader zprogram
+        // ------------------------------------
+        ourShader = loadShader("../cube/shader.vs", "../cube/shader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_TEXCOORD);
+
+
+        // load and create a texture 
+        // -------------------------
+        texture = loadTexture("../resources/textures/container.jpg");
+        texture2 = loadTexture("../resources/textures/awesomeface.png", true);
+
+        ourShader->use();
+        ourShader->setInt("texture", 0);
+        ourShader->setInt("texture2", 1);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2);
+
+        // transformations
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::rotate(model, wrappedAngle(renderTime(), glm::radians(50.0)), glm::vec3(0.5f, 1.0f, 0.0f));
+        glm::mat4 view = glm::mat4(1.0f);
+        // note that we're translating the scene in the reverse direction of where we want to move
+        view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
+        glm::mat4 projection = projectionMatrix();
+
+        // render container
+        ourShader->use();
+        unsigned int modelLoc = glGetUniformLocation(ourShader->ID, "model");
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+    }
+};
@@ -0,0 +1,43 @@
+#version 430 core
+out vec4 FragColor;
+
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+};
+
+uniform Material material;
+
+struct Light {
+    vec3 direction;
+    vec3 specular;
+};
+
+uniform Light light;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoord;
+in vec2 LightmapUV;
+uniform vec3 viewPos;
+
+// baked ambient, direct and bounced light in rgb, the light's visibility in a
+uniform sampler2D lightmap;
+
+void main()
+{
+    vec4 baked = texture(lightmap, LightmapUV);
+
+    // everything diffuse comes from the bake
+    vec3 diffuse = baked.rgb * texture(material.diffuse, TexCoord).rgb;
+
+    // specular depends on the view, so it stays per fragment, shadowed by the baked visibility
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(normalize(light.direction), norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    vec3 specular = light.specular * (spec * texture(material.specular, TexCoord).rgb);
+
+    FragColor = vec4(diffuse + baked.a * specular, 1.0);
+}
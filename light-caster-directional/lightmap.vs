@@ -0,0 +1,26 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
+// where the vertex sits in the baked lightmap, see LightmapBaker
+layout (location = 11) in vec2 aLightmapUV;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+out vec2 LightmapUV;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    FragPos = vec3(aModel * vec4(decodePosition(aPos), 1.0));
+    Normal = aNormalMatrix * decodeNormal(aNormal);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+
+    TexCoord = decodeTexCoord(aTexCoord);
+    LightmapUV = aLightmapUV;
+}
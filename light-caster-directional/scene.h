@@ -0,0 +1,251 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Light-casters
+*/
+#include <application.h>
+#include <instancedRenderer.h>
+#include <lighting.h>
+#include <lightmapBaker.h>
+#include <mesh.h>
+#include <shadowMaps.h>
+#include <staticBatch.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class LightCasterDirectional : public Application
+{
+    Shader* ourShader;
+    Shader* staticShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    InstancedRenderer cubeInstances;
+    // the cubes that don't spin, pre-transformed and merged
+    StaticBatch staticCubes;
+    unsigned int staticVAO;
+    // with lightingOptions().lightmaps: the static cubes' light, baked at load; they then don't
+    // receive the spinning cubes' shadows
+    bool lightmapped = false;
+    Shader* lightmapShader;
+    unsigned int lightmap;
+    unsigned int lightmapUVs;
+    unsigned int diffuseMap;
+    unsigned int specularMap;
+
+    // the light's shadows: the static cubes' depth stays cached per cascade, the spinning cubes are
+    // drawn over it in the cascades they reach
+    CascadedShadowMaps shadows;
+    Shader* shadowShader;
+    Shader* staticShadowShader;
+    unsigned int shadowVAO;
+    unsigned int staticShadowVAO;
+    glm::vec4 cubeBounds;
+
+    glm::vec3 lightPos = glm::vec3(10.0f, 2.0f, -10.0f);
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../light-caster-directional/shader.vs", "../light-caster-directional/shader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+        // per-cube transforms
+        cubeInstances.attach(VAO, frameData);
+
+        // a cube with no rotation never moves: it is baked into world space once instead of being
+        // instanced every frame
+        for (unsigned int i = 0; i < (sizeof(cubePositions) / sizeof(*cubePositions)); i++) {
+            if (rotationSpeed(i) == 0.0f) {
+                staticCubes.add(cubeMesh(), cubeModel(i, 0.0));
+            }
+        }
+        staticCubes.build();
+        staticShader = loadShader("../light-caster-directional/shader.vs", "../light-caster-directional/shader.fs", staticCubes.shaderDecode());
+        staticVAO = staticCubes.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+        lightmapped = lightingOptions().lightmaps && staticCubes.size() > 0;
+        if (lightmapped) {
+            LightmapBaker baker;
+            baker.setGeometry(staticCubes.mesh());
+            baker.addDirectionalLight(lightPos, glm::vec3(0.5f));
+            baker.bake();
+            lightmap = baker.createTexture();
+            lightmapUVs = baker.attachUV2(staticVAO, staticCubes.vertexBase());
+            lightmapShader = loadShader("../light-caster-directional/lightmap.vs", "../light-caster-directional/lightmap.fs", staticCubes.shaderDecode());
+            glUseProgram(lightmapShader->ID);
+            glUniform1i(glGetUniformLocation(lightmapShader->ID, "material.diffuse"), 0);
+            glUniform1i(glGetUniformLocation(lightmapShader->ID, "material.specular"), 1);
+            glUniform1i(glGetUniformLocation(lightmapShader->ID, "lightmap"), LIGHTMAP_UNIT);
+        }
+
+        // shadow casters, positions only
+        shadows.init();
+        cubeBounds = boundingSphere(cubeMesh());
+        shadowShader = loadShader("../light-caster-directional/shadow.vs", "../light-caster-directional/shadow.fs", cube.shaderDecode());
+        shadowVAO = cube.createPositionArray();
+        cubeInstances.attach(shadowVAO, frameData);
+        staticShadowShader = loadShader("../light-caster-directional/shadow.vs", "../light-caster-directional/shadow.fs", staticCubes.shaderDecode());
+        staticShadowVAO = staticCubes.createVertexArray(VERTEX_POSITION);
+
+        // load and create a textures
+        // -------------------------
+        diffuseMap = loadTexture("../resources/textures/container2.png");
+        specularMap = loadTexture("../resources/textures/container2_specular.png");
+
+
+        // Set Texture in shader
+        for (Shader* shader : { ourShader, staticShader }) {
+            glUseProgram(shader->ID);
+            glUniform1i(glGetUniformLocation(shader->ID, "material.diffuse"), 0);
+            glUniform1i(glGetUniformLocation(shader->ID, "material.specular"), 1);
+        }
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // the spinning cubes go out in one instanced draw, per pass
+        cubeInstances.clear();
+        for (unsigned int i = 0; i < (sizeof(cubePositions) / sizeof(*cubePositions)); i++) {
+            if (rotationSpeed(i) != 0.0f) {
+                glm::mat4 model = cubeModel(i, renderTime());
+                cubeInstances.add(model);
+                shadows.addMovingCaster(transformSphere(model, cubeBounds));
+            }
+        }
+        renderShadows(view, projection);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap);
+
+        // static cubes: a draw per visible chunk
+        Shader* shader = lightmapped ? lightmapShader : staticShader;
+        if (lightmapped) {
+            glActiveTexture(GL_TEXTURE0 + LIGHTMAP_UNIT);
+            glBindTexture(GL_TEXTURE_2D, lightmap);
+        }
+        glUseProgram(shader->ID);
+        setUniforms(shader->ID, view, projection);
+        staticCubes.draw(staticVAO, 0, projection * view);
+
+        // render container
+        glUseProgram(ourShader->ID);
+        setUniforms(ourShader->ID, view, projection);
+        cubeInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+    }
+
+    // the cascades fitted to this view; only what the cache doesn't hold is drawn
+    void renderShadows(const glm::mat4& view, const glm::mat4& projection)
+    {
+        shadows.fit(view, projection, lightPos);
+        for (unsigned int c = 0; c < shadows.layerCount(); c++) {
+            const glm::mat4& lightMatrix = shadows.layerMatrix(c);
+            if (shadows.beginStatic(c)) {
+                glUseProgram(staticShadowShader->ID);
+                glUniformMatrix4fv(glGetUniformLocation(staticShadowShader->ID, "lightMatrix"), 1, GL_FALSE, glm::value_ptr(lightMatrix));
+                staticCubes.draw(staticShadowVAO, 0, lightMatrix);
+            }
+            if (shadows.beginDynamic(c)) {
+                glUseProgram(shadowShader->ID);
+                glUniformMatrix4fv(glGetUniformLocation(shadowShader->ID, "lightMatrix"), 1, GL_FALSE, glm::value_ptr(lightMatrix));
+                cubeInstances.drawElements(shadowVAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+            }
+        }
+        shadows.end();
+    }
+
+    // degrees per second cube i spins at
+    static float rotationSpeed(unsigned int i)
+    {
+        return 20.0f * i;
+    }
+
+    glm::mat4 cubeModel(unsigned int i, double time) const
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
+        model = glm::rotate(model, wrappedAngle(time, glm::radians((double)rotationSpeed(i))), glm::vec3(1.0f, 0.3f, 0.5f));
+        return model;
+    }
+
+    void setUniforms(unsigned int id, const glm::mat4& view, const glm::mat4& projection)
+    {
+        // Light Color
+        unsigned int lightAmbientLoc = glGetUniformLocation(id, "light.ambient");
+        glUniform3fv(lightAmbientLoc, 1, glm::value_ptr(glm::vec3(0.1f)));
+
+        glm::vec3 diffuseLight(0.5f);
+        unsigned int lightDiffuseLoc = glGetUniformLocation(id, "light.diffuse");
+        glUniform3fv(lightDiffuseLoc, 1, glm::value_ptr(diffuseLight));
+
+        unsigned int lightSpecularLoc = glGetUniformLocation(id, "light.specular");
+        glUniform3fv(lightSpecularLoc, 1, glm::value_ptr(glm::vec3(1.0f)));
+
+        unsigned int lightDirectionLoc = glGetUniformLocation(id, "light.direction");
+        glUniform3fv(lightDirectionLoc, 1, glm::value_ptr(lightPos));
+
+        unsigned int shininessLoc = glGetUniformLocation(id, "material.shininess");
+        glUniform1f(shininessLoc, 2.0f);
+
+        unsigned int viewLoc = glGetUniformLocation(id, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(id, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+        // View
+        unsigned int viewPosLoc = glGetUniformLocation(id, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+        shadows.setUniforms(id);
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteVertexArrays(1, &staticVAO);
+        glDeleteVertexArrays(1, &shadowVAO);
+        glDeleteVertexArrays(1, &staticShadowVAO);
+        cube.destroy();
+        cubeInstances.destroy();
+        staticCubes.destroy();
+        shadows.destroy();
+        if (lightmapped) {
+            glDeleteTextures(1, &lightmap);
+            glDeleteBuffers(1, &lightmapUVs);
+        }
+    }
+};
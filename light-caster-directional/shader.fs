@@ -22,8 +22,31 @@ uniform Light light;
 in vec3 Normal;
 in vec3 FragPos;
 in vec2 TexCoord;
+in float ViewDepth;
 uniform vec3 viewPos;
 
+// cascaded shadow maps of the light, see CascadedShadowMaps
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 lightMatrices[4];
+uniform vec4 cascadeSplits;  // view depth each cascade ends at
+uniform vec4 cascadeTexels;  // world units a texel of each cascade covers
+
+// 1 lit, 0 in shadow; nothing past the last cascade is shadowed
+float CalcShadow(vec3 normal)
+{
+    if (ViewDepth > cascadeSplits[3]) {
+        return 1.0;
+    }
+    int cascade = 0;
+    while (ViewDepth > cascadeSplits[cascade]) {
+        cascade++;
+    }
+    // looked up a texel and a half off the surface, against acne
+    vec3 position = FragPos + normal * (1.5 * cascadeTexels[cascade]);
+    vec3 coord = (lightMatrices[cascade] * vec4(position, 1.0)).xyz * 0.5 + 0.5;
+    return texture(shadowMap, vec4(coord.xy, float(cascade), coord.z));
+}
+
 void main()
 {
     // ambient
@@ -40,7 +63,8 @@ void main()
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
     vec3 specular = light.specular * (spec * texture(material.specular, TexCoord).rgb);
-            
-    vec3 result = (ambient + diffuse + specular);
+
+    float shadow = CalcShadow(norm);
+    vec3 result = (ambient + shadow * (diffuse + specular));
     FragColor = vec4(result, 1.0);
 } 
\ No newline at end of file
@@ -0,0 +1,5 @@
+#version 430 core
+// shadow casters: depth only
+void main()
+{
+}
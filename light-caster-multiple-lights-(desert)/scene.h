@@ -0,0 +1,247 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Light-casters
+https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+*/
+#include <application.h>
+#include <instancedRenderer.h>
+#include <lightManager.h>
+#include <lighting.h>
+#include <mesh.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <vector>
+
+class LightCasterMultipleLightsDesert : public Application
+{
+    Shader* ourShader;
+    Shader* lightShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    InstancedRenderer cubeInstances;
+    unsigned int diffuseMap;
+    unsigned int specularMap;
+    unsigned int lightVAO;
+
+    // the four lights of the demo, then lightingOptions().extraPointLights small moving ones; each
+    // cube only shades the ones LightManager finds reaching its bounding sphere
+    std::vector<PointLightData> pointLights;
+    LightManager lightManager;
+    glm::vec4 cubeBounds;
+
+    glm::vec3 lightPos = glm::vec3(5.0f, 2.0f, -2.5f);
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    glm::vec3 pointLightPositions[4] = {
+        glm::vec3(0.7f,  0.2f,  2.0f),
+        glm::vec3(2.3f, -3.3f, -4.0f),
+        glm::vec3(-4.0f,  2.0f, -12.0f),
+        glm::vec3(0.0f,  0.0f, -3.0f)
+    };
+
+    glm::vec3 pointLightDiffuse[4] = {
+        glm::vec3(0.8f, 0.7f, 0.4f),
+        glm::vec3(0.9f, 0.6f, 0.3f),
+        glm::vec3(0.7f, 0.4f, 0.2f),
+        glm::vec3(0.6f, 0.1f, 0.1f)
+    };
+    static const unsigned int pointLightCount = sizeof(pointLightPositions) / sizeof(*pointLightPositions);
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+        cubeBounds = boundingSphere(cubeMesh());
+        pointLights.resize(pointLightCount + lightingOptions().extraPointLights);
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../light-caster-multiple-lights-(desert)/shader.vs", "../light-caster-multiple-lights-(desert)/shader.fs", cube.shaderDecode());
+        lightShader = loadShader("../light-caster-multiple-lights-(desert)/lightShader.vs", "../light-caster-multiple-lights-(desert)/lightShader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+        // per-cube transforms
+        cubeInstances.attach(VAO, frameData);
+
+        // load and create a textures
+        // -------------------------
+        diffuseMap = loadTexture("../resources/textures/container2.png");
+        specularMap = loadTexture("../resources/textures/container2_specular.png");
+
+        // Light VAO
+        lightVAO = cube.createVertexArray(VERTEX_POSITION);
+
+
+        // Set Texture in shader
+        glUseProgram(ourShader->ID);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.diffuse"), 0);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.specular"), 1);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.9f, 0.5f, 0.25f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // render container
+        glUseProgram(ourShader->ID);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap);
+
+        relayDirectionLightParams(ourShader->ID);
+
+        for (unsigned int i = 0; i < pointLightCount; i++) {
+            setPointLight(pointLights[i], pointLightPositions[i], pointLightDiffuse[i]);
+        }
+        for (size_t i = pointLightCount; i < pointLights.size(); i++) {
+            pointLights[i] = extraPointLight((unsigned int)i, renderTime());
+        }
+        RingBuffer::bindStorage(POINT_LIGHTS_BINDING, frameData->upload(pointLights.data(), pointLights.size() * sizeof(PointLightData), frameData->storageAlignment()));
+        lightManager.setLights(pointLights);
+
+        relaySpotlightParams(ourShader->ID);
+
+        // material shininess
+        unsigned int shininessLoc = glGetUniformLocation(ourShader->ID, "material.shininess");
+        glUniform1f(shininessLoc, 2.0f);
+
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+        // View
+        unsigned int viewPosLoc = glGetUniformLocation(ourShader->ID, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+        // all cubes go out in one instanced draw, each with its own list of lights
+        cubeInstances.clear();
+        lightManager.clearObjects();
+        for (unsigned int i = 0; i < (sizeof(cubePositions) / sizeof(*cubePositions)); i++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, cubePositions[i]);
+            model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
+            float angle = 20.0f * i;
+            model = glm::rotate(model, wrappedAngle(renderTime(), glm::radians((double)angle)), glm::vec3(1.0f, 0.3f, 0.5f));
+            cubeInstances.add(model);
+            lightManager.addObject(model, cubeBounds);
+        }
+        lightManager.assign(frameData);
+        cubeInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+
+        for (unsigned int i = 0; i < pointLightCount; i++) {
+            drawLight(lightShader->ID, lightVAO, view, projection, pointLightDiffuse[i], pointLightPositions[i]);
+        }
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+        cubeInstances.destroy();
+    }
+
+    void relaySpotlightParams(unsigned int shaderId) {
+        unsigned int lightAmbientLoc = glGetUniformLocation(shaderId, "spotlight.ambient");
+        glUniform3fv(lightAmbientLoc, 1, glm::value_ptr(glm::vec3(0.1f)));
+
+        glm::vec3 diffuseLight(2.f);
+        unsigned int lightDiffuseLoc = glGetUniformLocation(shaderId, "spotlight.diffuse");
+        glUniform3fv(lightDiffuseLoc, 1, glm::value_ptr(diffuseLight));
+
+        unsigned int lightSpecularLoc = glGetUniformLocation(shaderId, "spotlight.specular");
+        glUniform3fv(lightSpecularLoc, 1, glm::value_ptr(glm::vec3(1.0f)));
+
+        unsigned int lightDirectionLoc = glGetUniformLocation(shaderId, "spotlight.direction");
+        glUniform3fv(lightDirectionLoc, 1, glm::value_ptr(camera.Front));
+
+        unsigned int lightPositionLoc = glGetUniformLocation(shaderId, "spotlight.position");
+        glUniform3fv(lightPositionLoc, 1, glm::value_ptr(camera.Position));
+
+        unsigned int lightCutOffLoc = glGetUniformLocation(shaderId, "spotlight.cutOff");
+        glUniform1f(lightCutOffLoc, glm::cos(glm::radians(1.5)));
+
+        unsigned int lightOuterCutOffLoc = glGetUniformLocation(shaderId, "spotlight.outerCutOff");
+        glUniform1f(lightOuterCutOffLoc, glm::cos(glm::radians(15.0)));
+
+        // attenuation levels
+        // https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+        unsigned int lightConstantLoc = glGetUniformLocation(shaderId, "spotlight.constant");
+        glUniform1f(lightConstantLoc, 1.0f);
+
+        unsigned int lightLinearLoc = glGetUniformLocation(shaderId, "spotlight.linear");
+        glUniform1f(lightLinearLoc, 0.09f);
+
+        unsigned int lightQuadraticLoc = glGetUniformLocation(shaderId, "spotlight.quadratic");
+        glUniform1f(lightQuadraticLoc, 0.032f);
+    }
+
+    void setPointLight(PointLightData& light, glm::vec3 lightPos, glm::vec3 diffuseLight) {
+        // ambient, diffuse, specular, then the attenuation levels
+        light = makePointLight(lightPos, diffuseLight, diffuseLight, diffuseLight + glm::vec3(0.2f), 1.0f, 0.09f, 0.032f);
+    }
+
+    void relayDirectionLightParams(unsigned int shaderId) {
+        unsigned int lightAmbientLoc = glGetUniformLocation(shaderId, "dirLight.ambient");
+        glUniform3fv(lightAmbientLoc, 1, glm::value_ptr(glm::vec3(0.1f)));
+
+        glm::vec3 diffuseLight(0.3f);
+        unsigned int lightDiffuseLoc = glGetUniformLocation(shaderId, "dirLight.diffuse");
+        glUniform3fv(lightDiffuseLoc, 1, glm::value_ptr(diffuseLight));
+
+        unsigned int lightSpecularLoc = glGetUniformLocation(shaderId, "dirLight.specular");
+        glUniform3fv(lightSpecularLoc, 1, glm::value_ptr(glm::vec3(1.0f)));
+
+        unsigned int lightDirectionLoc = glGetUniformLocation(shaderId, "dirLight.direction");
+        glUniform3fv(lightDirectionLoc, 1, glm::value_ptr(lightPos));
+    }
+
+    void drawLight(unsigned int shaderId, unsigned int VAO, glm::mat4 view, glm::mat4 projection, glm::vec3 diffuseLight, glm::vec3 lightPos) {
+        // Draw Light
+        glUseProgram(shaderId);
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, lightPos);
+        model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+        unsigned int modelLoc = glGetUniformLocation(shaderId, "model");
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        unsigned int viewLoc = glGetUniformLocation(shaderId, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(shaderId, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        unsigned int lightBoxColorLoc = glGetUniformLocation(shaderId, "lightColor");
+        glUniform3fv(lightBoxColorLoc, 1, glm::value_ptr(diffuseLight));
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+
+    }
+};
@@ -19,16 +19,12 @@ struct DirLight {
 
 uniform DirLight dirLight;
 
+// std430, see PointLightData in lighting.h: the attenuation terms ride in the w components
 struct PointLight {
-    vec3 position;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    vec4 position;  // w = range
+    vec4 ambient;   // w = constant
+    vec4 diffuse;   // w = linear
+    vec4 specular;  // w = quadratic
 };
 
 struct Spotlight {
@@ -49,12 +45,23 @@ struct Spotlight {
 
 uniform Spotlight spotlight;
 
-#define NR_POINT_LIGHTS 4
-uniform PointLight pointLights[NR_POINT_LIGHTS];
+layout (std430, binding = 1) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+
+// per instance, the lights reaching it (see LightManager)
+struct ObjectLights {
+    uint count;
+    uint lights[15];
+};
+layout (std430, binding = 4) readonly buffer ObjectLightLists {
+    ObjectLights objectLights[];
+};
 
 in vec3 Normal;
 in vec3 FragPos;
 in vec2 TexCoord;
+flat in uint Instance;
 uniform vec3 viewPos;
 
 vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
@@ -67,8 +74,9 @@ void main() {
 
     vec3 result = CalcDirLight(dirLight, norm, viewDir);
 
-    for(int i = 0; i < NR_POINT_LIGHTS; i++) {
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+    uint lightCount = objectLights[Instance].count;
+    for (uint i = 0u; i < lightCount; i++) {
+        result += CalcPointLight(pointLights[objectLights[Instance].lights[i]], norm, FragPos, viewDir);
     }
 
     result += CalcSpotlight(spotlight, norm, FragPos, viewDir);
@@ -94,7 +102,7 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir) {
 }
 
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-    vec3 lightDir = light.position - fragPos;
+    vec3 lightDir = light.position.xyz - fragPos;
     vec3 lightDirNorm = normalize(lightDir);
 
     // diffuse
@@ -106,12 +114,14 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
 
     // attenuation
     float distance = length(lightDir);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    float attenuation = 1.0 / (light.ambient.w + light.diffuse.w * distance + light.specular.w * (distance * distance));
+    // nothing past the range, as the lists assume
+    attenuation *= step(distance, light.position.w);
 
     // combine
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoord));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoord));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoord));
+    vec3 ambient = light.ambient.rgb * vec3(texture(material.diffuse, TexCoord));
+    vec3 diffuse = light.diffuse.rgb * diff * vec3(texture(material.diffuse, TexCoord));
+    vec3 specular = light.specular.rgb * spec * vec3(texture(material.specular, TexCoord));
 
     ambient *= attenuation;
     diffuse *= attenuation;
@@ -0,0 +1,193 @@
+#version 430 core
+// deferred lighting: every light once per covered pixel, reading the G-buffer; the point lights come
+// from the pixel's cluster, see ClusteredLighting
+out vec4 FragColor;
+
+struct DirLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+// std430, see PointLightData in lighting.h: the attenuation terms ride in the w components
+struct PointLight {
+    vec4 position;  // w = range
+    vec4 ambient;   // w = constant
+    vec4 diffuse;   // w = linear
+    vec4 specular;  // w = quadratic
+};
+
+struct Spotlight {
+    vec3 position;
+    vec3 direction;
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    float cutOff;
+    float outerCutOff;
+};
+
+// the same block the forward shader reads, see LightBlock in scene.h
+layout (std140, binding = 0) uniform Lights {
+    DirLight dirLight;
+    Spotlight spotlight;
+};
+
+layout (std430, binding = 1) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+layout (std430, binding = 2) readonly buffer LightGrid {
+    uvec2 lightGrid[];
+};
+layout (std430, binding = 3) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+uniform uvec3 clusterGrid;
+uniform vec2 clusterScale;  // tiles per pixel
+uniform vec3 clusterDepth;  // near, far, slices / log(far / near)
+
+uniform sampler2D albedoSpecular;
+uniform sampler2D normalShininess;
+uniform sampler2D depth;
+// window coordinates (pixel, depth buffer value) to world space
+uniform mat4 screenToWorld;
+uniform vec3 viewPos;
+
+struct Surface {
+    vec3 position;
+    vec3 normal;
+    vec3 albedo;
+    float specular;
+    float shininess;
+};
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+vec3 CalcDirLight(DirLight light, Surface surface, vec3 viewDir);
+vec3 CalcPointLight(PointLight light, Surface surface, vec3 viewDir);
+vec3 CalcSpotlight(Spotlight light, Surface surface, vec3 viewDir);
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float z = texelFetch(depth, pixel, 0).r;
+    if (z == 1.0) {
+        // nothing was drawn here; the clear colour stays
+        discard;
+    }
+    vec4 position = screenToWorld * vec4(vec2(pixel) + 0.5, z, 1.0);
+    vec4 albedo = texelFetch(albedoSpecular, pixel, 0);
+    vec4 normal = texelFetch(normalShininess, pixel, 0);
+
+    Surface surface;
+    surface.position = position.xyz / position.w;
+    surface.normal = decodeOctahedral(normal.xy * 2.0 - 1.0);
+    surface.albedo = albedo.rgb;
+    surface.specular = albedo.a;
+    surface.shininess = exp2(normal.b * 10.0);
+    vec3 viewDir = normalize(viewPos - surface.position);
+
+    vec3 result = CalcDirLight(dirLight, surface, viewDir);
+
+    // the pixel's cluster: its screen tile, and the exponential slice of its view depth
+    uvec2 tile = min(uvec2(gl_FragCoord.xy * clusterScale), clusterGrid.xy - 1u);
+    float viewDepth = clusterDepth.x * clusterDepth.y / (clusterDepth.y - z * (clusterDepth.y - clusterDepth.x));
+    uint slice = uint(clamp(log(viewDepth / clusterDepth.x) * clusterDepth.z, 0.0, float(clusterGrid.z - 1u)));
+    uvec2 cluster = lightGrid[(slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x];
+    for (uint i = 0u; i < cluster.y; i++) {
+        result += CalcPointLight(pointLights[lightIndices[cluster.x + i]], surface, viewDir);
+    }
+
+    result += CalcSpotlight(spotlight, surface, viewDir);
+    FragColor = vec4(result, 1.0);
+    // the light boxes drawn afterwards depth test against the G-buffer's depth
+    gl_FragDepth = z;
+}
+
+vec3 CalcDirLight(DirLight light, Surface surface, vec3 viewDir) {
+    vec3 lightDir = normalize(-light.direction);
+    
+    // diffuse
+    float diff = max(dot(surface.normal, lightDir), 0.0);
+
+    // specular
+    vec3 reflectDir = reflect(-lightDir, surface.normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+
+    // combine
+    vec3 ambient = light.ambient * surface.albedo;
+    vec3 diffuse = light.diffuse * diff * surface.albedo;
+    vec3 specular = light.specular * spec * surface.specular;
+    return ambient + diffuse + specular;
+}
+
+vec3 CalcPointLight(PointLight light, Surface surface, vec3 viewDir) {
+    vec3 lightDir = light.position.xyz - surface.position;
+    vec3 lightDirNorm = normalize(lightDir);
+
+    // diffuse
+    float diff = max(dot(surface.normal, lightDirNorm), 0.0);
+
+    // specular
+    vec3 reflectDir = reflect(-lightDirNorm, surface.normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+
+    // attenuation
+    float distance = length(lightDir);
+    float attenuation = 1.0 / (light.ambient.w + light.diffuse.w * distance + light.specular.w * (distance * distance));
+    attenuation *= step(distance, light.position.w);
+
+    // combine
+    vec3 ambient = light.ambient.rgb * surface.albedo;
+    vec3 diffuse = light.diffuse.rgb * diff * surface.albedo;
+    vec3 specular = light.specular.rgb * spec * surface.specular;
+
+    ambient *= attenuation;
+    diffuse *= attenuation;
+    specular *= attenuation;
+    return ambient + diffuse + specular;
+}
+
+vec3 CalcSpotlight(Spotlight light, Surface surface, vec3 viewDir) {
+    vec3 lightDir = light.position - surface.position;
+    vec3 lightDirNorm = normalize(lightDir);
+
+    float theta = dot(lightDirNorm, normalize(-light.direction));
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+
+    // attentuation
+    float distance = length(lightDir);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+    // ambient
+    vec3 ambient = light.ambient * surface.albedo;
+
+    // diffuse 
+    float diff = max(dot(surface.normal, lightDirNorm), 0.0);
+    vec3 diffuse = light.diffuse * diff * surface.albedo;
+    diffuse *= attenuation;
+    diffuse *= intensity;
+
+    // specular
+    vec3 reflectDir = reflect(-lightDirNorm, surface.normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+    vec3 specular = light.specular * (spec * surface.specular);
+    specular *= attenuation;
+    specular *= intensity;
+            
+    return ambient + diffuse + specular;
+}
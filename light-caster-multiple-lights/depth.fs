@@ -0,0 +1,5 @@
+#version 430 core
+// depth prepass: no colour output
+void main()
+{
+}
@@ -0,0 +1,16 @@
+#version 430 core
+// depth prepass: positions only, transformed exactly as shader.vs does
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aModel;
+
+// shader.vs's lit pass tests GL_EQUAL against these depths
+invariant gl_Position;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    vec3 FragPos = vec3(aModel * vec4(decodePosition(aPos), 1.0));
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
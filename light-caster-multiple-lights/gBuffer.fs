@@ -0,0 +1,28 @@
+#version 430 core
+// deferred geometry pass: surface attributes only, see GBuffer
+layout (location = 0) out vec4 AlbedoSpecular;
+layout (location = 1) out vec4 NormalShininess;
+
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float     shininess;
+};
+
+uniform Material material;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCoord;
+
+// unit vector onto the octahedron, unfolded into [-1, 1]^2
+vec2 encodeOctahedral(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 folded = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return n.z >= 0.0 ? n.xy : folded;
+}
+
+void main() {
+    AlbedoSpecular = vec4(texture(material.diffuse, TexCoord).rgb, texture(material.specular, TexCoord).r);
+    NormalShininess = vec4(encodeOctahedral(normalize(Normal)) * 0.5 + 0.5, log2(material.shininess) / 10.0, 0.0);
+}
@@ -0,0 +1,426 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Light-casters
+https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+*/
+#include <application.h>
+#include <clusteredLighting.h>
+#include <gBuffer.h>
+#include <instancedRenderer.h>
+#include <lighting.h>
+#include <mesh.h>
+#include <overdraw.h>
+#include <tiledLighting.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <vector>
+
+class LightCasterMultipleLights : public Application
+{
+    // std140 mirrors of the shader's Lights block: a vec3 takes 16 bytes unless a float fits after it
+    struct DirLightData {
+        glm::vec3 direction; float pad0;
+        glm::vec3 ambient; float pad1;
+        glm::vec3 diffuse; float pad2;
+        glm::vec3 specular; float pad3;
+    };
+
+    struct SpotlightData {
+        glm::vec3 position; float pad0;
+        glm::vec3 direction; float pad1;
+        glm::vec3 ambient; float pad2;
+        glm::vec3 diffuse; float pad3;
+        glm::vec3 specular;
+        float constant;
+        float linear;
+        float quadratic;
+        float cutOff;
+        float outerCutOff;
+    };
+
+    // the point lights go to their own storage buffer, see PointLightData
+    struct LightBlock {
+        DirLightData dirLight;
+        SpotlightData spotlight;
+    };
+    static_assert(sizeof(LightBlock) == 64 + 96, "LightBlock must match the std140 layout of Lights");
+
+    Shader* ourShader;
+    Shader* lightShader;
+    unsigned int VAO, lightVAO;
+    MeshBuffer cube;
+    InstancedRenderer cubeInstances;
+    unsigned int diffuseMap, specularMap;
+
+    // the four lights of the demo, then lightingOptions().extraPointLights small moving ones
+    std::vector<PointLightData> pointLights;
+    bool clustered = false;
+    ClusteredLighting clusters;
+
+    // LIGHTING_DEFERRED: the cubes go to the G-buffer, then one full-screen pass lights every covered
+    // pixel, with the point lights of its cluster
+    bool deferred = false;
+    Shader* gBufferShader;
+    Shader* deferredShader;
+    GBuffer gBuffer;
+    unsigned int screenVAO = 0;
+
+    // LIGHTING_TILED: a position-only depth pass, then per-tile light lists for the usual shader
+    bool tiled = false;
+    TiledLighting tiles;
+
+    // lightingOptions().depthPrepass: the same depth pass into the screen's depth buffer, before a
+    // GL_EQUAL lit pass
+    bool prepass = false;
+    Shader* depthShader;
+    unsigned int depthVAO = 0;
+    bool measuring = false;
+    OverdrawQueries queries;
+
+    glm::vec3 lightPos = glm::vec3(5.0f, 2.0f, -2.5f);
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    glm::vec3 pointLightPositions[4] = {
+        glm::vec3(0.7f,  0.2f,  2.0f),
+        glm::vec3(2.3f, -3.3f, -4.0f),
+        glm::vec3(-4.0f,  2.0f, -12.0f),
+        glm::vec3(0.0f,  0.0f, -3.0f)
+    };
+
+    static const unsigned int cubeCount = sizeof(cubePositions) / sizeof(*cubePositions);
+    static const unsigned int pointLightCount = sizeof(pointLightPositions) / sizeof(*pointLightPositions);
+    Transform previousCubes[cubeCount];
+    Transform currentCubes[cubeCount];
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../light-caster-multiple-lights/shader.vs", "../light-caster-multiple-lights/shader.fs", cube.shaderDecode());
+        lightShader = loadShader("../light-caster-multiple-lights/lightShader.vs", "../light-caster-multiple-lights/lightShader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+        // per-cube transforms
+        cubeInstances.attach(VAO, frameData);
+
+        // load and create a textures
+        // -------------------------
+        diffuseMap = loadTexture("../resources/textures/container2.png");
+        specularMap = loadTexture("../resources/textures/container2_specular.png");
+
+        // Light VAO
+        lightVAO = cube.createVertexArray(VERTEX_POSITION);
+
+
+        // Set Texture in shader
+        glUseProgram(ourShader->ID);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.diffuse"), 0);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.specular"), 1);
+
+        for (unsigned int i = 0; i < cubeCount; i++) {
+            currentCubes[i].position = cubePositions[i];
+            previousCubes[i] = currentCubes[i];
+        }
+
+        pointLights.resize(pointLightCount + lightingOptions().extraPointLights);
+        clustered = lightingOptions().path == LIGHTING_CLUSTERED;
+        deferred = lightingOptions().path == LIGHTING_DEFERRED;
+        if (clustered || deferred) {
+            clusters.init();
+        }
+        if (deferred) {
+            gBufferShader = loadShader("../light-caster-multiple-lights/shader.vs", "../light-caster-multiple-lights/gBuffer.fs", cube.shaderDecode());
+            deferredShader = loadShader("../light-caster-multiple-lights/deferred.vs", "../light-caster-multiple-lights/deferred.fs");
+            glProgramUniform1i(gBufferShader->ID, glGetUniformLocation(gBufferShader->ID, "material.diffuse"), 0);
+            glProgramUniform1i(gBufferShader->ID, glGetUniformLocation(gBufferShader->ID, "material.specular"), 1);
+            glProgramUniform1i(deferredShader->ID, glGetUniformLocation(deferredShader->ID, "albedoSpecular"), 0);
+            glProgramUniform1i(deferredShader->ID, glGetUniformLocation(deferredShader->ID, "normalShininess"), 1);
+            glProgramUniform1i(deferredShader->ID, glGetUniformLocation(deferredShader->ID, "depth"), 2);
+            // the lighting pass makes its triangle from gl_VertexID
+            glGenVertexArrays(1, &screenVAO);
+        }
+        tiled = lightingOptions().path == LIGHTING_TILED;
+        if (tiled) {
+            tiles.init();
+        }
+        prepass = lightingOptions().depthPrepass && (lightingOptions().path == LIGHTING_FORWARD || clustered);
+        measuring = lightingOptions().measureOverdraw && !deferred && !tiled;
+        if (tiled || prepass || measuring) {
+            depthShader = loadShader("../light-caster-multiple-lights/depth.vs", "../light-caster-multiple-lights/depth.fs", cube.shaderDecode());
+            depthVAO = cube.createPositionArray();
+            cubeInstances.attach(depthVAO, frameData);
+        }
+        if (measuring) {
+            queries.init("light-caster-multiple-lights", prepass);
+        }
+    }
+
+    void update(double step) override
+    {
+        for (unsigned int i = 0; i < cubeCount; i++) {
+            previousCubes[i] = currentCubes[i];
+            float angle = 20.0f * i;
+            currentCubes[i].rotation = glm::angleAxis(wrappedAngle(frameLoop.simulationTime(), glm::radians((double)angle)), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)));
+        }
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // point lights, binned into clusters before the draws that read them
+        glm::vec3 diffuseLight(.8f);
+        for (unsigned int i = 0; i < pointLightCount; i++) {
+            setPointLight(pointLights[i], pointLightPositions[i], diffuseLight);
+        }
+        setExtraPointLights(renderTime());
+        RingBuffer::bindStorage(POINT_LIGHTS_BINDING, frameData->upload(pointLights.data(), pointLights.size() * sizeof(PointLightData), frameData->storageAlignment()));
+        glProgramUniform1ui(ourShader->ID, glGetUniformLocation(ourShader->ID, "pointLightCount"), (GLuint)pointLights.size());
+        if (clustered || deferred) {
+            clusters.assign(view, projection, (unsigned int)pointLights.size());
+            clusters.setUniforms(deferred ? deferredShader->ID : ourShader->ID, width, height);
+        }
+
+        // all cubes go out in one instanced draw, per pass
+        cubeInstances.clear();
+        for (unsigned int i = 0; i < cubeCount; i++) {
+            glm::mat4 model = interpolate(previousCubes[i], currentCubes[i], alpha).matrix();
+            cubeInstances.add(model);
+        }
+        if (tiled) {
+            renderTileDepth(view, projection);
+            tiles.assign(view, projection, (unsigned int)pointLights.size());
+            tiles.setUniforms(ourShader->ID);
+        }
+        if (prepass) {
+            if (measuring) {
+                queries.begin(OverdrawQueries::PREPASS);
+            }
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            drawDepth(view, projection);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            if (measuring) {
+                queries.end(OverdrawQueries::PREPASS);
+            }
+            // the lit pass only shades what the prepass left visible
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+        }
+
+        // render container, to the screen or, deferred, to the G-buffer
+        unsigned int containerShader = deferred ? gBufferShader->ID : ourShader->ID;
+        GLint target = 0;
+        if (deferred) {
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+            gBuffer.resize(width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, gBuffer.framebuffer);
+            glClear(GL_DEPTH_BUFFER_BIT);
+        }
+        glUseProgram(containerShader);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap);
+
+        // every light parameter goes to the GPU as one block instead of ~40 glUniform calls
+        LightBlock lights;
+        setDirectionLight(lights.dirLight);
+        setSpotlight(lights.spotlight);
+        RingBuffer::bindUniform(0, frameData->upload(&lights, sizeof(lights), frameData->uniformAlignment()));
+
+        // material shininess
+        unsigned int shininessLoc = glGetUniformLocation(containerShader, "material.shininess");
+        glUniform1f(shininessLoc, 2.0f);
+
+        unsigned int viewLoc = glGetUniformLocation(containerShader, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(containerShader, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+        // View
+        unsigned int viewPosLoc = glGetUniformLocation(containerShader, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+        if (measuring) {
+            queries.begin(OverdrawQueries::LIT);
+        }
+        cubeInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+        if (measuring) {
+            queries.end(OverdrawQueries::LIT);
+        }
+        if (prepass) {
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+        } else if (measuring) {
+            // the pixels left visible: the depth once more, passing only where it is what's in the buffer
+            queries.begin(OverdrawQueries::VISIBLE);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+            drawDepth(view, projection);
+            glDepthMask(GL_TRUE);
+            glDepthFunc(GL_LESS);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            queries.end(OverdrawQueries::VISIBLE);
+        }
+        if (measuring) {
+            queries.endFrame();
+        }
+
+        if (deferred) {
+            glBindFramebuffer(GL_FRAMEBUFFER, target);
+            lightGBuffer(view, projection);
+        }
+
+        // the extra lights go without a box
+        for (unsigned int i = 0; i < pointLightCount; i++) {
+            drawLight(lightShader->ID, lightVAO, view, projection, diffuseLight, pointLightPositions[i]);
+        }
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteVertexArrays(1, &lightVAO);
+        cube.destroy();
+        cubeInstances.destroy();
+        if (clustered || deferred) {
+            clusters.destroy();
+        }
+        if (deferred) {
+            gBuffer.destroy();
+            glDeleteVertexArrays(1, &screenVAO);
+        }
+        if (tiled) {
+            tiles.destroy();
+        }
+        if (depthVAO != 0) {
+            glDeleteVertexArrays(1, &depthVAO);
+        }
+        queries.destroy();
+    }
+
+    // the cubes through the position-only program
+    void drawDepth(const glm::mat4& view, const glm::mat4& projection) {
+        glUseProgram(depthShader->ID);
+        glUniformMatrix4fv(glGetUniformLocation(depthShader->ID, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(depthShader->ID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        cubeInstances.drawElements(depthVAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+    }
+
+    // the cubes' depth into the tile lists' depth target; restores the framebuffer bound
+    void renderTileDepth(const glm::mat4& view, const glm::mat4& projection) {
+        GLint target = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+        tiles.resize(width, height);
+        glBindFramebuffer(GL_FRAMEBUFFER, tiles.depthFramebuffer);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        drawDepth(view, projection);
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+    }
+
+    // the deferred lighting pass, into the framebuffer bound
+    void lightGBuffer(const glm::mat4& view, const glm::mat4& projection) {
+        // from (pixel, depth) through NDC back to the world
+        glm::mat4 windowToNdc = glm::translate(glm::mat4(1.0f), glm::vec3(-1.0f)) * glm::scale(glm::mat4(1.0f), glm::vec3(2.0f / width, 2.0f / height, 2.0f));
+        glm::mat4 screenToWorld = glm::inverse(projection * view) * windowToNdc;
+        gBuffer.bindTextures(0);
+        glBindVertexArray(screenVAO);
+
+        // also copies the G-buffer's depth, for the light boxes drawn next
+        glUseProgram(deferredShader->ID);
+        glUniformMatrix4fv(glGetUniformLocation(deferredShader->ID, "screenToWorld"), 1, GL_FALSE, glm::value_ptr(screenToWorld));
+        glUniform3fv(glGetUniformLocation(deferredShader->ID, "viewPos"), 1, glm::value_ptr(camera.Position));
+        glDepthFunc(GL_ALWAYS);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glDepthFunc(GL_LESS);
+    }
+
+    void setSpotlight(SpotlightData& light) {
+        light.ambient = glm::vec3(0.1f);
+        light.diffuse = glm::vec3(2.f);
+        light.specular = glm::vec3(1.0f);
+        light.direction = camera.Front;
+        light.position = camera.Position;
+        light.cutOff = glm::cos(glm::radians(1.5f));
+        light.outerCutOff = glm::cos(glm::radians(15.0f));
+
+        // attenuation levels
+        // https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+        light.constant = 1.0f;
+        light.linear = 0.09f;
+        light.quadratic = 0.032f;
+    }
+
+    void setPointLight(PointLightData& light, glm::vec3 lightPos, glm::vec3 diffuseLight) {
+        // ambient, diffuse, specular, then the attenuation levels
+        light = makePointLight(lightPos, glm::vec3(0.1f), diffuseLight, glm::vec3(1.0f), 1.0f, 0.09f, 0.032f);
+    }
+
+    // Dim coloured lights drifting on circles around the cubes. The steep attenuation (range 7 in the
+    // Ogre table) at a quarter of the brightness ends their reach at about 2.4 units, which keeps each to
+    // a few clusters and is what lets thousands of them stay cheap.
+    void setExtraPointLights(double time) {
+        for (size_t i = pointLightCount; i < pointLights.size(); i++) {
+            pointLights[i] = extraPointLight((unsigned int)i, time);
+        }
+    }
+
+    void setDirectionLight(DirLightData& light) {
+        light.ambient = glm::vec3(0.1f);
+        light.diffuse = glm::vec3(0.3f);
+        light.specular = glm::vec3(1.0f);
+        light.direction = lightPos;
+    }
+
+    void drawLight(unsigned int shaderId, unsigned int VAO, glm::mat4 view, glm::mat4 projection, glm::vec3 diffuseLight, glm::vec3 lightPos) {
+        // Draw Light
+        glUseProgram(shaderId);
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, lightPos);
+        model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+        unsigned int modelLoc = glGetUniformLocation(shaderId, "model");
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        unsigned int viewLoc = glGetUniformLocation(shaderId, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(shaderId, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        unsigned int lightBoxColorLoc = glGetUniformLocation(shaderId, "lightColor");
+        glUniform3fv(lightBoxColorLoc, 1, glm::value_ptr(diffuseLight));
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+
+    }
+};
@@ -17,18 +17,12 @@ struct DirLight {
     vec3 specular;
 };
 
-uniform DirLight dirLight;
-
+// std430, see PointLightData in lighting.h: the attenuation terms ride in the w components
 struct PointLight {
-    vec3 position;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    vec4 position;  // w = range
+    vec4 ambient;   // w = constant
+    vec4 diffuse;   // w = linear
+    vec4 specular;  // w = quadratic
 };
 
 struct Spotlight {
@@ -47,10 +41,29 @@ struct Spotlight {
     float outerCutOff;
 };
 
-uniform Spotlight spotlight;
+// written once per frame into the application's frame ring, see LightBlock in scene.h
+layout (std140, binding = 0) uniform Lights {
+    DirLight dirLight;
+    Spotlight spotlight;
+};
+
+// any number of point lights, also from the frame ring
+layout (std430, binding = 1) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+uniform uint pointLightCount;
 
-#define NR_POINT_LIGHTS 4
-uniform PointLight pointLights[NR_POINT_LIGHTS];
+// clustered shading (see ClusteredLighting): per cluster an (offset, count) pair into lightIndices;
+// with clusterGrid left at zero every fragment walks all lights
+layout (std430, binding = 2) readonly buffer LightGrid {
+    uvec2 lightGrid[];
+};
+layout (std430, binding = 3) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+uniform uvec3 clusterGrid;
+uniform vec2 clusterScale;  // tiles per pixel
+uniform vec3 clusterDepth;  // near, far, slices / log(far / near)
 
 in vec3 Normal;
 in vec3 FragPos;
@@ -67,8 +80,21 @@ void main() {
 
     vec3 result = CalcDirLight(dirLight, norm, viewDir);
 
-    for(int i = 0; i < NR_POINT_LIGHTS; i++) {
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+    uint first = 0u;
+    uint count = pointLightCount;
+    bool clustered = clusterGrid.x > 0u;
+    if (clustered) {
+        // view depth back from the depth buffer value, then the exponential slice it falls in
+        uvec2 tile = min(uvec2(gl_FragCoord.xy * clusterScale), clusterGrid.xy - 1u);
+        float depth = clusterDepth.x * clusterDepth.y / (clusterDepth.y - gl_FragCoord.z * (clusterDepth.y - clusterDepth.x));
+        uint slice = uint(clamp(log(depth / clusterDepth.x) * clusterDepth.z, 0.0, float(clusterGrid.z - 1u)));
+        uvec2 cluster = lightGrid[(slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x];
+        first = cluster.x;
+        count = cluster.y;
+    }
+    for(uint i = 0u; i < count; i++) {
+        uint light = clustered ? lightIndices[first + i] : i;
+        result += CalcPointLight(pointLights[light], norm, FragPos, viewDir);
     }
 
     result += CalcSpotlight(spotlight, norm, FragPos, viewDir);
@@ -94,7 +120,7 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir) {
 }
 
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-    vec3 lightDir = light.position - fragPos;
+    vec3 lightDir = light.position.xyz - fragPos;
     vec3 lightDirNorm = normalize(lightDir);
 
     // diffuse
@@ -106,12 +132,14 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
 
     // attenuation
     float distance = length(lightDir);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    float attenuation = 1.0 / (light.ambient.w + light.diffuse.w * distance + light.specular.w * (distance * distance));
+    // nothing past the range, so every path (see LightingPath) agrees on what a light reaches
+    attenuation *= step(distance, light.position.w);
 
     // combine
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoord));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoord));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoord));
+    vec3 ambient = light.ambient.rgb * vec3(texture(material.diffuse, TexCoord));
+    vec3 diffuse = light.diffuse.rgb * diff * vec3(texture(material.diffuse, TexCoord));
+    vec3 specular = light.specular.rgb * spec * vec3(texture(material.specular, TexCoord));
 
     ambient *= attenuation;
     diffuse *= attenuation;
@@ -0,0 +1,238 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Light-casters
+https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+*/
+#include <application.h>
+#include <instancedRenderer.h>
+#include <lighting.h>
+#include <mesh.h>
+#include <shadowMaps.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class LightCasterPoint : public Application
+{
+    Shader* ourShader;
+    Shader* lightShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    // the spinning cubes, every frame
+    InstancedRenderer cubeInstances;
+    // the ones that never move, once
+    InstancedRenderer staticInstances;
+    unsigned int diffuseMap;
+    unsigned int specularMap;
+    unsigned int lightVAO;
+
+    // the light's shadows: the static cubes' depth stays cached per cube face, the spinning cubes are
+    // drawn over it in the faces they reach
+    PointShadowMap shadows;
+    Shader* shadowShader;
+    unsigned int shadowVAO;
+    glm::vec4 cubeBounds;
+
+    glm::vec3 lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../light-caster-point/shader.vs", "../light-caster-point/shader.fs", cube.shaderDecode());
+        lightShader = loadShader("../light-caster-point/lightShader.vs", "../light-caster-point/lightShader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+        // per-cube transforms
+        cubeInstances.attach(VAO, frameData);
+        staticInstances.attach(VAO);
+        for (unsigned int i = 0; i < (sizeof(cubePositions) / sizeof(*cubePositions)); i++) {
+            if (rotationSpeed(i) == 0.0f) {
+                staticInstances.add(cubeModel(i, 0.0));
+            }
+        }
+
+        // shadow casters, positions only
+        shadows.init();
+        cubeBounds = boundingSphere(cubeMesh());
+        shadowShader = loadShader("../light-caster-point/shadow.vs", "../light-caster-point/shadow.fs", cube.shaderDecode());
+        shadowVAO = cube.createPositionArray();
+        cubeInstances.attach(shadowVAO, frameData);
+        staticInstances.attach(shadowVAO);
+
+        // load and create a textures
+        // -------------------------
+        diffuseMap = loadTexture("../resources/textures/container2.png");
+        specularMap = loadTexture("../resources/textures/container2_specular.png");
+
+        // Light VAO
+        lightVAO = cube.createVertexArray(VERTEX_POSITION);
+
+
+        // Set Texture in shader
+        glUseProgram(ourShader->ID);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.diffuse"), 0);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.specular"), 1);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // the spinning cubes go out in one instanced draw, per pass
+        cubeInstances.clear();
+        for (unsigned int i = 0; i < (sizeof(cubePositions) / sizeof(*cubePositions)); i++) {
+            if (rotationSpeed(i) != 0.0f) {
+                glm::mat4 model = cubeModel(i, renderTime());
+                cubeInstances.add(model);
+                shadows.addMovingCaster(transformSphere(model, cubeBounds));
+            }
+        }
+        renderShadows();
+
+        // render container
+        glUseProgram(ourShader->ID);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap);
+
+        // Light Color
+        unsigned int lightAmbientLoc = glGetUniformLocation(ourShader->ID, "light.ambient");
+        glUniform3fv(lightAmbientLoc, 1, glm::value_ptr(glm::vec3(0.1f)));
+
+        glm::vec3 diffuseLight(2.f);
+        unsigned int lightDiffuseLoc = glGetUniformLocation(ourShader->ID, "light.diffuse");
+        glUniform3fv(lightDiffuseLoc, 1, glm::value_ptr(diffuseLight));
+
+        unsigned int lightSpecularLoc = glGetUniformLocation(ourShader->ID, "light.specular");
+        glUniform3fv(lightSpecularLoc, 1, glm::value_ptr(glm::vec3(1.0f)));
+
+        unsigned int lightPositionLoc = glGetUniformLocation(ourShader->ID, "light.position");
+        glUniform3fv(lightPositionLoc, 1, glm::value_ptr(lightPos));
+
+        // attenuation levels
+        unsigned int lightConstantLoc = glGetUniformLocation(ourShader->ID, "light.constant");
+        glUniform1f(lightConstantLoc, 1.0f);
+
+        unsigned int lightLinearLoc = glGetUniformLocation(ourShader->ID, "light.linear");
+        glUniform1f(lightLinearLoc, 0.09f);
+
+        unsigned int lightQuadraticLoc = glGetUniformLocation(ourShader->ID, "light.quadratic");
+        glUniform1f(lightQuadraticLoc, 0.032f);
+
+        // material shininess
+        unsigned int shininessLoc = glGetUniformLocation(ourShader->ID, "material.shininess");
+        glUniform1f(shininessLoc, 2.0f);
+
+        // View/projection transformations
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+        // View position
+        unsigned int viewPosLoc = glGetUniformLocation(ourShader->ID, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+        shadows.setUniforms(ourShader->ID);
+        staticInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+        cubeInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+
+        drawLight(lightShader->ID, lightVAO, view, projection, diffuseLight);
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteVertexArrays(1, &shadowVAO);
+        cube.destroy();
+        cubeInstances.destroy();
+        staticInstances.destroy();
+        shadows.destroy();
+    }
+
+    // the cube faces out to the light's range; only what the cache doesn't hold is drawn
+    void renderShadows()
+    {
+        shadows.fit(lightPos, pointLightRange(1.0f, 0.09f, 0.032f, 2.0f));
+        glUseProgram(shadowShader->ID);
+        for (unsigned int face = 0; face < shadows.layerCount(); face++) {
+            const glm::mat4& lightMatrix = shadows.layerMatrix(face);
+            if (shadows.beginStatic(face)) {
+                glUniformMatrix4fv(glGetUniformLocation(shadowShader->ID, "lightMatrix"), 1, GL_FALSE, glm::value_ptr(lightMatrix));
+                staticInstances.drawElements(shadowVAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+            }
+            if (shadows.beginDynamic(face)) {
+                glUniformMatrix4fv(glGetUniformLocation(shadowShader->ID, "lightMatrix"), 1, GL_FALSE, glm::value_ptr(lightMatrix));
+                cubeInstances.drawElements(shadowVAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+            }
+        }
+        shadows.end();
+    }
+
+    // degrees per second cube i spins at
+    static float rotationSpeed(unsigned int i)
+    {
+        return 20.0f * i;
+    }
+
+    glm::mat4 cubeModel(unsigned int i, double time) const
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
+        model = glm::rotate(model, wrappedAngle(time, glm::radians((double)rotationSpeed(i))), glm::vec3(1.0f, 0.3f, 0.5f));
+        return model;
+    }
+
+    void drawLight(unsigned int shaderId, unsigned int VAO, glm::mat4 view, glm::mat4 projection, glm::vec3 diffuseLight) {
+        // Draw Light
+        glUseProgram(shaderId);
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, lightPos);
+        model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+        unsigned int modelLoc = glGetUniformLocation(shaderId, "model");
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        unsigned int viewLoc = glGetUniformLocation(shaderId, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(shaderId, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        unsigned int lightBoxColorLoc = glGetUniformLocation(shaderId, "lightColor");
+        glUniform3fv(lightBoxColorLoc, 1, glm::value_ptr(diffuseLight));
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+
+    }
+};
@@ -28,6 +28,28 @@ in vec3 FragPos;
 in vec2 TexCoord;
 uniform vec3 viewPos;
 
+// the light's depth cube, see PointShadowMap
+uniform samplerCubeShadow pointShadowMap;
+uniform vec2 pointShadowDepth;  // near, far of the faces
+
+// 1 lit, 0 in shadow
+float CalcShadow(vec3 normal)
+{
+    vec3 toFragment = FragPos - light.position;
+    // looked up a texel and a half off the surface, against acne; a texel spans 2 * distance / size
+    toFragment += normal * (3.0 * length(toFragment) / float(textureSize(pointShadowMap, 0).x));
+    // the face's depth is the perspective depth of the largest axis
+    vec3 axes = abs(toFragment);
+    float z = max(axes.x, max(axes.y, axes.z));
+    float n = pointShadowDepth.x;
+    float f = pointShadowDepth.y;
+    if (z >= f) {
+        return 1.0;
+    }
+    float depth = (f + n) / (f - n) - 2.0 * f * n / ((f - n) * z);
+    return texture(pointShadowMap, vec4(toFragment, depth * 0.5 + 0.5));
+}
+
 void main()
 {
     vec3 lightDir = light.position - FragPos;
@@ -53,7 +75,8 @@ void main()
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
     vec3 specular = light.specular * (spec * texture(material.specular, TexCoord).rgb);
     specular *= attenuation;
-            
-    vec3 result = (ambient + diffuse + specular);
+
+    float shadow = CalcShadow(norm);
+    vec3 result = (ambient + shadow * (diffuse + specular));
     FragColor = vec4(result, 1.0);
 } 
\ No newline at end of file
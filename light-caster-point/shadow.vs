@@ -0,0 +1,11 @@
+#version 430 core
+// shadow casters: positions only, into a face of PointShadowMap
+layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aModel;
+
+uniform mat4 lightMatrix;
+
+void main()
+{
+    gl_Position = lightMatrix * aModel * vec4(decodePosition(aPos), 1.0);
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Light-casters
+https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+*/
+#include <application.h>
+#include <instancedRenderer.h>
+#include <mesh.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class LightCasterSpotlight2 : public Application
+{
+    Shader* ourShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    InstancedRenderer cubeInstances;
+    unsigned int diffuseMap;
+    unsigned int specularMap;
+
+    glm::vec3 lightPos = glm::vec3(5.0f, 2.0f, -2.5f);
+
+    glm::vec3 cubePositions[10] = {
+        glm::vec3(0.0f,  0.0f,  0.0f),
+        glm::vec3(2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3(2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3(1.3f, -2.0f, -2.5f),
+        glm::vec3(1.5f,  2.0f, -2.5f),
+        glm::vec3(1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../light-caster-spotlight-(flashlight)-2/shader.vs", "../light-caster-spotlight-(flashlight)-2/shader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+        // per-cube transforms
+        cubeInstances.attach(VAO, frameData);
+
+        // load and create a textures
+        // -------------------------
+        diffuseMap = loadTexture("../resources/textures/container2.png");
+        specularMap = loadTexture("../resources/textures/container2_specular.png");
+
+        // Set Texture in shader
+        glUseProgram(ourShader->ID);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.diffuse"), 0);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.specular"), 1);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // render container
+        glUseProgram(ourShader->ID);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap);
+
+        // Light Color
+        unsigned int lightAmbientLoc = glGetUniformLocation(ourShader->ID, "light.ambient");
+        glUniform3fv(lightAmbientLoc, 1, glm::value_ptr(glm::vec3(0.1f)));
+
+        glm::vec3 diffuseLight(2.f);
+        unsigned int lightDiffuseLoc = glGetUniformLocation(ourShader->ID, "light.diffuse");
+        glUniform3fv(lightDiffuseLoc, 1, glm::value_ptr(diffuseLight));
+
+        unsigned int lightSpecularLoc = glGetUniformLocation(ourShader->ID, "light.specular");
+        glUniform3fv(lightSpecularLoc, 1, glm::value_ptr(glm::vec3(1.0f)));
+
+        unsigned int lightDirectionLoc = glGetUniformLocation(ourShader->ID, "light.direction");
+        glUniform3fv(lightDirectionLoc, 1, glm::value_ptr(camera.Front));
+
+        unsigned int lightPositionLoc = glGetUniformLocation(ourShader->ID, "light.position");
+        glUniform3fv(lightPositionLoc, 1, glm::value_ptr(camera.Position));
+
+        unsigned int lightCutOffLoc = glGetUniformLocation(ourShader->ID, "light.cutOff");
+        glUniform1f(lightCutOffLoc, glm::cos(glm::radians(1.5)));
+
+        unsigned int lightOuterCutOffLoc = glGetUniformLocation(ourShader->ID, "light.outerCutOff");
+        glUniform1f(lightOuterCutOffLoc, glm::cos(glm::radians(15.0)));
+
+        // attenuation levels
+        // https://wiki.ogre3d.org/tiki-index.php?page=-Point+Light+Attenuation
+        unsigned int lightConstantLoc = glGetUniformLocation(ourShader->ID, "light.constant");
+        glUniform1f(lightConstantLoc, 1.0f);
+
+        unsigned int lightLinearLoc = glGetUniformLocation(ourShader->ID, "light.linear");
+        glUniform1f(lightLinearLoc, 0.09f);
+
+        unsigned int lightQuadraticLoc = glGetUniformLocation(ourShader->ID, "light.quadratic");
+        glUniform1f(lightQuadraticLoc, 0.032f);
+
+        // material shininess
+        unsigned int shininessLoc = glGetUniformLocation(ourShader->ID, "material.shininess");
+        glUniform1f(shininessLoc, 2.0f);
+
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+        // View
+        unsigned int viewPosLoc = glGetUniformLocation(ourShader->ID, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+        // all cubes go out in one instanced draw
+        cubeInstances.clear();
+        for (unsigned int i = 0; i < (sizeof(cubePositions) / sizeof(*cubePositions)); i++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, cubePositions[i]);
+            model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
+            float angle = 20.0f * i;
+            model = glm::rotate(model, wrappedAngle(renderTime(), glm::radians((double)angle)), glm::vec3(1.0f, 0.3f, 0.5f));
+            cubeInstances.add(model);
+        }
+        cubeInstances.drawElements(VAO, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset());
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+        cubeInstances.destroy();
+    }
+};
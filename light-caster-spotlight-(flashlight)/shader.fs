@@ -63,6 +63,6 @@ void main()
         vec3 result = (ambient + diffuse + specular);
         FragColor = vec4(result, 1.0);
     } else {
-        FragColor = vec4(light.ambient * texture(material.diffuse, TexCoord), 1.0);
+        FragColor = vec4(light.ambient * texture(material.diffuse, TexCoord).rgb, 1.0);
     }
 } 
\ No newline at end of file
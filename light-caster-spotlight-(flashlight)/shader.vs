@@ -2,22 +2,23 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    // Inversing a matrix is expensive in a shader and should be done on the CPU
-    Normal = mat3(transpose(inverse(model))) * aNormal;    
+    FragPos = vec3(aModel * vec4(decodePosition(aPos), 1.0));
+    // inverse transpose of the model matrix, computed on the CPU per instance
+    Normal = aNormalMatrix * decodeNormal(aNormal);    
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 
-    TexCoord = aTexCoord;
+    TexCoord = decodeTexCoord(aTexCoord);
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+// the cube at rest, see SpinAnimation
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
+// unit axis in xyz, radians per second in w
+layout (location = 13) in vec4 aSpin;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float time;
+
+// rotation by `angle` about the unit `axis`, as glm::rotate builds it
+mat3 spinMatrix(vec3 axis, float angle)
+{
+    float c = cos(angle);
+    float s = sin(angle);
+    vec3 t = (1.0 - c) * axis;
+    return mat3(
+        c + t.x * axis.x,          t.x * axis.y + s * axis.z, t.x * axis.z - s * axis.y,
+        t.y * axis.x - s * axis.z, c + t.y * axis.y,          t.y * axis.z + s * axis.x,
+        t.z * axis.x + s * axis.y, t.z * axis.y - s * axis.x, c + t.z * axis.z);
+}
+
+void main()
+{
+    mat3 spin = spinMatrix(aSpin.xyz, aSpin.w * time);
+    FragPos = vec3(aModel * vec4(spin * decodePosition(aPos), 1.0));
+    // a rotation is its own inverse transpose, so the rest normal matrix only needs the spin applied
+    Normal = aNormalMatrix * (spin * decodeNormal(aNormal));
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+
+    TexCoord = decodeTexCoord(aTexCoord);
+}
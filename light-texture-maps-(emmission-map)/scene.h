@@ -0,0 +1,148 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Lighting-maps
+*/
+#include <application.h>
+#include <mesh.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class LightTextureMapsEmissionMap : public Application
+{
+    Shader* ourShader;
+    Shader* lightShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    unsigned int diffuseMap;
+    unsigned int specularMap;
+    unsigned int emissionMap;
+    unsigned int lightVAO;
+
+    glm::vec3 lightPos = glm::vec3(0.0f, 0.7f, 0.0f);
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(0.0f, 0.0f, 5.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../light-texture-maps-(emmission-map)/shader.vs", "../light-texture-maps-(emmission-map)/shader.fs", cube.shaderDecode());
+        lightShader = loadShader("../light-texture-maps-(emmission-map)/lightShader.vs", "../light-texture-maps-(emmission-map)/lightShader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+
+        // load and create a textures
+        // -------------------------
+        diffuseMap = loadTexture("../resources/textures/container2.png");
+        specularMap = loadTexture("../resources/textures/container2_specular.png");
+        emissionMap = loadTexture("../resources/textures/matrix.jpg");
+
+
+        // Light VAO
+        lightVAO = cube.createVertexArray(VERTEX_POSITION);
+
+
+        // Set Texture in shader
+        glUseProgram(ourShader->ID);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.diffuse"), 0);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.specular"), 1);
+        glUniform1i(glGetUniformLocation(ourShader->ID, "material.emission"), 2);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const float radius = 2.0f;
+        float lightX = sin(renderTime()) * radius;
+        float lightZ = cos(renderTime()) * radius;
+        glm::vec3 newLightPos = lightPos + glm::vec3(lightX, lightPos.y, lightZ);
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // render container
+        glUseProgram(ourShader->ID);
+
+        // bind Texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, diffuseMap);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, specularMap);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, emissionMap);
+
+        unsigned int modelLoc = glGetUniformLocation(ourShader->ID, "model");
+
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        glBindVertexArray(VAO);
+
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(1.0f, 1.0f, 1.0f));
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+
+        // View
+        unsigned int viewPosLoc = glGetUniformLocation(ourShader->ID, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+
+        // Light Color
+        unsigned int lightAmbientLoc = glGetUniformLocation(ourShader->ID, "light.ambient");
+        glUniform3fv(lightAmbientLoc, 1, glm::value_ptr(glm::vec3(0.5f)));
+
+        glm::vec3 diffuseLight(0.5f);
+        unsigned int lightDiffuseLoc = glGetUniformLocation(ourShader->ID, "light.diffuse");
+        glUniform3fv(lightDiffuseLoc, 1, glm::value_ptr(diffuseLight));
+
+        unsigned int lightSpecularLoc = glGetUniformLocation(ourShader->ID, "light.specular");
+        glUniform3fv(lightSpecularLoc, 1, glm::value_ptr(glm::vec3(1.0f)));
+
+        unsigned int lightPositionLoc = glGetUniformLocation(ourShader->ID, "light.position");
+        glUniform3fv(lightPositionLoc, 1, glm::value_ptr(newLightPos));
+
+        unsigned int shininessLoc = glGetUniformLocation(ourShader->ID, "material.shininess");
+        glUniform1f(shininessLoc, 2.0f);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+
+
+        drawLight(lightShader->ID, lightVAO, view, projection, diffuseLight, newLightPos);
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+    }
+
+    void drawLight(unsigned int shaderId, unsigned int VAO, glm::mat4 view, glm::mat4 projection, glm::vec3 diffuseLight, glm::vec3 lightPos) {
+        glUseProgram(shaderId);
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, lightPos);
+        model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+        unsigned int modelLoc = glGetUniformLocation(shaderId, "model");
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        unsigned int viewLoc = glGetUniformLocation(shaderId, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(shaderId, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        unsigned int lightBoxColorLoc = glGetUniformLocation(shaderId, "lightColor");
+        glUniform3fv(lightBoxColorLoc, 1, glm::value_ptr(diffuseLight));
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+    }
+};
@@ -0,0 +1,14 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+// ambient + diffuse, baked per vertex on the CPU (see VertexLightBaker)
+layout (location = 12) in vec4 aColor;
+
+out vec3 LightingColor;
+
+uniform mat4 modelViewProjection;
+
+void main()
+{
+    gl_Position = modelViewProjection * vec4(decodePosition(aPos), 1.0);
+    LightingColor = aColor.rgb;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Basic-Lighting
+*/
+#include <application.h>
+#include <lighting.h>
+#include <mesh.h>
+#include <vertexLightBaker.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class LightingSpecularGouraudRotating : public Application
+{
+    Shader* ourShader;
+    Shader* lightShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    unsigned int lightVAO;
+
+    // with lightingOptions().bakedVertexLighting the light stays at lightPos and the cube's ambient and
+    // diffuse are baked into a colour per vertex at load; no specular
+    bool baked = false;
+    Shader* bakedShader;
+    unsigned int bakedVAO;
+    unsigned int bakedColours;
+
+    glm::vec3 lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
+    glm::vec3 objectColor = glm::vec3(1.0f, 0.5f, 0.31f);
+    glm::vec3 lightColor = glm::vec3(1.0f, 0.5f, 0.5f);
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(8.0f, 0.0f, 20.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../lighting-specular-(gouraud)-rotating/shader.vs", "../lighting-specular-(gouraud)-rotating/shader.fs", cube.shaderDecode());
+        lightShader = loadShader("../lighting-specular-(gouraud)-rotating/lightShader.vs", "../lighting-specular-(gouraud)-rotating/lightShader.fs", cube.shaderDecode());
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL);
+
+
+        // Light VAO
+        lightVAO = cube.createVertexArray(VERTEX_POSITION);
+
+        baked = lightingOptions().bakedVertexLighting;
+        if (baked) {
+            VertexLightBaker baker;
+            baker.setLight(lightPos, lightColor, 0.1f);
+            bakedShader = loadShader("../lighting-specular-(gouraud)-rotating/baked.vs", "../lighting-specular-(gouraud)-rotating/baked.fs", cube.shaderDecode());
+            // attach() adds the colours at location 12, so not the VAO vertex pulling shares
+            bakedVAO = cube.createUnsharedVertexArray(VERTEX_POSITION);
+            bakedColours = VertexLightBaker::attach(bakedVAO, baker.bake(cubeMesh(), cubeModel(), objectColor), cube.vertexBase());
+        }
+    }
+
+    glm::mat4 cubeModel() const
+    {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(2.0f, 3.5f, 1.2f));
+        return model;
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const float radius = 5.0f;
+        float lightX = sin(renderTime()) * radius;
+        float lightZ = cos(renderTime()) * radius;
+        float lightY = (cos(renderTime() / 2) + sin(renderTime() / 3)) * radius;
+        glm::vec3 newLightPos = lightPos + glm::vec3(lightX, lightY, lightZ);
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        if (baked) {
+            // the lighting is in the vertices already: a transform and a colour
+            glUseProgram(bakedShader->ID);
+            glm::mat4 modelViewProjection = projection * view * cubeModel();
+            glUniformMatrix4fv(glGetUniformLocation(bakedShader->ID, "modelViewProjection"), 1, GL_FALSE, glm::value_ptr(modelViewProjection));
+            glBindVertexArray(bakedVAO);
+            glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+            drawLight(lightShader->ID, lightVAO, view, projection, lightPos);
+            return;
+        }
+
+        // render container
+        glUseProgram(ourShader->ID);
+        unsigned int modelLoc = glGetUniformLocation(ourShader->ID, "model");
+
+        unsigned int viewLoc = glGetUniformLocation(ourShader->ID, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(ourShader->ID, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        glBindVertexArray(VAO);
+
+        glm::mat4 model = cubeModel();
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+
+        unsigned int objectColorLoc = glGetUniformLocation(ourShader->ID, "objectColor");
+        glUniform3fv(objectColorLoc, 1, glm::value_ptr(objectColor));
+        unsigned int lightColorLoc = glGetUniformLocation(ourShader->ID, "lightColor");
+        glUniform3fv(lightColorLoc, 1, glm::value_ptr(lightColor));
+
+        unsigned int lightPositionLoc = glGetUniformLocation(ourShader->ID, "lightPos");
+        glUniform3fv(lightPositionLoc, 1, glm::value_ptr(newLightPos));
+
+        unsigned int viewPosLoc = glGetUniformLocation(ourShader->ID, "viewPos");
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+
+
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+
+        drawLight(lightShader->ID, lightVAO, view, projection, newLightPos);
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        if (baked) {
+            glDeleteVertexArrays(1, &bakedVAO);
+            glDeleteBuffers(1, &bakedColours);
+        }
+        cube.destroy();
+    }
+
+    void drawLight(unsigned int shaderId, unsigned int VAO, glm::mat4 view, glm::mat4 projection, glm::vec3 lightPos) {
+        glUseProgram(shaderId);
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, lightPos);
+        model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+        unsigned int modelLoc = glGetUniformLocation(shaderId, "model");
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        unsigned int viewLoc = glGetUniformLocation(shaderId, "view");
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        unsigned int projectionLoc = glGetUniformLocation(shaderId, "projection");
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, cube.indexCount(), cube.indexType(), (void*)cube.indexOffset());
+
+    }
+};
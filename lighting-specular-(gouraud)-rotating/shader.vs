@@ -16,9 +16,9 @@ uniform vec3 lightColor;
 // Gouraud shading
 void main()
 {
-    vec3 Pos = vec3(model * vec4(aPos, 1.0));
+    vec3 Pos = vec3(model * vec4(decodePosition(aPos), 1.0));
     // Inversing a matrix is expensive in a shader and should be done on the CPU
-    vec3 Normal = mat3(transpose(inverse(model))) * aNormal;    
+    vec3 Normal = mat3(transpose(inverse(model))) * decodeNormal(aNormal);    
     
     gl_Position = projection * view * vec4(Pos, 1.0);
 
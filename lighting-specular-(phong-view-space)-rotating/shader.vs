@@ -14,9 +14,9 @@ uniform vec3 lightPos;
 
 void main()
 {
-    FragPos = vec3(view * model * vec4(aPos, 1.0));
+    FragPos = vec3(view * model * vec4(decodePosition(aPos), 1.0));
     // Inversing a matrix is expensive in a shader and should be done on the CPU
-    Normal = mat3(transpose(inverse(view * model))) * aNormal;
+    Normal = mat3(transpose(inverse(view * model))) * decodeNormal(aNormal);
     LightPos = vec3(view * vec4(lightPos, 1.0)); // Transform world-space light position to view-space light position
     gl_Position = projection * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -7,5 +7,5 @@ uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * vec4(decodePosition(aPos), 1.0);
 } 
\ No newline at end of file
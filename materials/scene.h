@@ -0,0 +1,175 @@
+#pragma once
+
+/*
+https://learnopengl.com/Lighting/Materials
+*/
+#include <application.h>
+#include <mesh.h>
+#include <renderQueue.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+class Materials : public Application
+{
+    struct MaterialCube {
+        const char* name;
+        glm::vec3 position;
+        glm::vec3 ambient;
+        glm::vec3 diffuse;
+        glm::vec3 specular;
+        float shininess;
+    };
+
+    // the light cube's RenderItem::user, the other draws use their index into materialCubes()
+    static const unsigned int LIGHT_CUBE = ~0u;
+
+    Shader* ourShader;
+    Shader* lightShader;
+    unsigned int VAO;
+    MeshBuffer cube;
+    unsigned int lightVAO;
+    RenderQueue queue;
+
+    // uniform locations, looked up once
+    int modelLoc, ambientLoc, diffuseLoc, specularLoc, shininessLoc;
+    int lightModelLoc;
+
+    glm::vec3 lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
+
+    static const MaterialCube* materialCubes(unsigned int* count)
+    {
+        /* http://devernay.free.fr/cours/opengl/materials.html */
+        static const MaterialCube cubes[] = {
+            { "Tutorial material", glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.5f, 0.31f), glm::vec3(1.0f, 0.5f, 0.31f), glm::vec3(0.5f, 0.5f, 0.5f), 32.0f },
+            { "Emerald", glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(0.0215f, 0.1745f, 0.0215f), glm::vec3(0.07568f, 0.61424f, 0.07568f), glm::vec3(0.633f, 0.727811f, 0.633f), 0.6f },
+            { "Jade", glm::vec3(4.0f, 0.0f, 0.0f), glm::vec3(0.135f, 0.1575f, 0.0215f), glm::vec3(0.54f, 0.89f, 0.63f), glm::vec3(0.316228f, 0.316228f, 0.316228f), 0.1f },
+            { "Obsidian", glm::vec3(6.0f, 0.0f, 0.0f), glm::vec3(0.05375f, 0.05f, 0.06625f), glm::vec3(0.18275f, 0.17f, 0.22525f), glm::vec3(0.332741f, 0.328634f, 0.346435f), 0.3f },
+            { "Pearl", glm::vec3(8.0f, 0.0f, 0.0f), glm::vec3(0.25f, 0.20725f, 0.20725f), glm::vec3(1.0f, 0.829f, 0.829f), glm::vec3(0.296648f, 0.296648f, 0.296648f), 0.088f },
+            { "Ruby", glm::vec3(0.0f, -2.0f, 0.0f), glm::vec3(0.1745f, 0.01175f, 0.01175f), glm::vec3(0.61424f, 0.04136f, 0.04136f), glm::vec3(0.727811f, 0.626959f, 0.626959f), 0.6f },
+            { "Turquoise", glm::vec3(2.0f, -2.0f, 0.0f), glm::vec3(0.1f, 0.18725f, 0.1745f), glm::vec3(0.396f, 0.74151f, 0.69102f), glm::vec3(0.297254f, 0.30829f, 0.306678f), 0.1f },
+            { "Brass", glm::vec3(4.0f, -2.0f, 0.0f), glm::vec3(0.329412f, 0.223529f, 0.027451f), glm::vec3(0.780392f, 0.568627f, 0.113725f), glm::vec3(0.992157f, 0.941176f, 0.807843f), 0.21794872f },
+            { "Bronze", glm::vec3(6.0f, -2.0f, 0.0f), glm::vec3(0.2125f, 0.1275f, 0.054f), glm::vec3(0.714f, 0.4284f, 0.18144f), glm::vec3(0.393548f, 0.271906f, 0.166721f), 0.2f },
+            { "Chrome", glm::vec3(8.0f, -2.0f, 0.0f), glm::vec3(0.25f, 0.25f, 0.25f), glm::vec3(0.4f, 0.4f, 0.4f), glm::vec3(0.774597f, 0.774597f, 0.774597f), 0.6f },
+            { "Copper", glm::vec3(0.0f, -4.0f, 0.0f), glm::vec3(0.19125f, 0.0735f, 0.0225f), glm::vec3(0.7038f, 0.27048f, 0.0828f), glm::vec3(0.256777f, 0.137622f, 0.086014f), 0.1f },
+            { "Gold", glm::vec3(2.0f, -4.0f, 0.0f), glm::vec3(0.24725f, 0.1995f, 0.0745f), glm::vec3(0.75164f, 0.60648f, 0.22648f), glm::vec3(0.628281f, 0.555802f, 0.366065f), 0.4f },
+            { "Silver", glm::vec3(4.0f, -4.0f, 0.0f), glm::vec3(0.19225f, 0.19225f, 0.19225f), glm::vec3(0.50754f, 0.50754f, 0.50754f), glm::vec3(0.508273f, 0.508273f, 0.508273f), 0.4f },
+            { "Black Plastic", glm::vec3(6.0f, -4.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.01f, 0.01f, 0.01f), glm::vec3(0.50f, 0.50f, 0.50f), 0.25f },
+            { "Cyan Plastic", glm::vec3(8.0f, -4.0f, 0.0f), glm::vec3(0.0f, 0.1f, 0.06f), glm::vec3(0.0f, 0.50980392f, 0.50980392f), glm::vec3(0.50980392f, 0.50980392f, 0.50980392f), 0.25f },
+            { "Green Plastic", glm::vec3(0.0f, -6.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.1f, 0.35f, 0.1f), glm::vec3(0.45f, 0.55f, 0.45f), 0.25f },
+            { "Red Plastic", glm::vec3(2.0f, -6.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(0.7f, 0.6f, 0.6f), 0.25f },
+            { "White Plastic", glm::vec3(4.0f, -6.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.55f, 0.55f, 0.55f), glm::vec3(0.70f, 0.70f, 0.70f), 0.25f },
+            { "Yellow Plastic", glm::vec3(6.0f, -6.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.60f, 0.60f, 0.60f), 0.25f },
+            { "Black Rubber", glm::vec3(8.0f, -6.0f, 0.0f), glm::vec3(0.02f, 0.02f, 0.02f), glm::vec3(0.01f, 0.01f, 0.01f), glm::vec3(0.4f, 0.4f, 0.4f), 0.078125f },
+            { "Cyan Rubber", glm::vec3(0.0f, -8.0f, 0.0f), glm::vec3(0.0f, 0.05f, 0.05f), glm::vec3(0.4f, 0.5f, 0.5f), glm::vec3(0.04f, 0.7f, 0.7f), 0.078125f },
+            { "Green Rubber", glm::vec3(2.0f, -8.0f, 0.0f), glm::vec3(0.0f, 0.05f, 0.0f), glm::vec3(0.4f, 0.5f, 0.5f), glm::vec3(0.04f, 0.7f, 0.04f), 0.078125f },
+            { "Red Rubber", glm::vec3(4.0f, -8.0f, 0.0f), glm::vec3(0.05f, 0.0f, 0.0f), glm::vec3(0.5f, 0.4f, 0.4f), glm::vec3(0.7f, 0.7f, 0.04f), 0.078125f },
+            { "White Rubber", glm::vec3(6.0f, -8.0f, 0.0f), glm::vec3(0.05f, 0.05f, 0.05f), glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(0.7f, 0.7f, 0.7f), 0.078125f },
+            { "Yellow Rubber", glm::vec3(8.0f, -8.0f, 0.0f), glm::vec3(0.05f, 0.05f, 0.0f), glm::vec3(0.5f, 0.5f, 0.4f), glm::vec3(0.7f, 0.7f, 0.04f), 0.078125f },
+        };
+        *count = sizeof(cubes) / sizeof(cubes[0]);
+        return cubes;
+    }
+
+    void init() override
+    {
+        camera = Camera(glm::vec3(4.5f, -4.5f, 20.0f));
+
+        // Enable z-buffer
+        glEnable(GL_DEPTH_TEST);
+
+        // set up vertex data (and buffer(s)) and configure vertex attributes
+        // ------------------------------------------------------------------
+        // the shared cube, welded, reordered for the vertex cache and packed to 16 bytes a vertex
+        cube.upload(cubeMesh());
+
+        // build and compile our shader program
+        // ------------------------------------
+        ourShader = loadShader("../materials/shader.vs", "../materials/shader.fs", cube.shaderDecode());
+        lightShader = loadShader("../materials/lightShader.vs", "../materials/lightShader.fs", cube.shaderDecode());
+
+        modelLoc = glGetUniformLocation(ourShader->ID, "model");
+        ambientLoc = glGetUniformLocation(ourShader->ID, "material.ambient");
+        diffuseLoc = glGetUniformLocation(ourShader->ID, "material.diffuse");
+        specularLoc = glGetUniformLocation(ourShader->ID, "material.specular");
+        shininessLoc = glGetUniformLocation(ourShader->ID, "material.shininess");
+        lightModelLoc = glGetUniformLocation(lightShader->ID, "model");
+
+        VAO = cube.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL);
+
+
+        // Light VAO
+        lightVAO = cube.createVertexArray(VERTEX_POSITION);
+    }
+
+    void render(double alpha) override
+    {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const float radius = 8.0f;
+        float lightX = sin(renderTime()) * radius;
+        float lightZ = cos(renderTime()) * radius;
+        float lightY = (cos(renderTime() / 2) + sin(renderTime() / 3)) * radius;
+        glm::vec3 newLightPos = lightPos + glm::vec3(lightX, lightY, lightZ);
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = projectionMatrix();
+
+        // per-frame uniforms go straight to the programs, the queue decides when each is bound
+        // ------------------------------------------------------------------------------------
+        unsigned int id = ourShader->ID;
+        glProgramUniformMatrix4fv(id, glGetUniformLocation(id, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glProgramUniformMatrix4fv(id, glGetUniformLocation(id, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        // Light
+        glProgramUniform3fv(id, glGetUniformLocation(id, "lightColor"), 1, glm::value_ptr(glm::vec3(1.0f, 0.5f, 0.5f)));
+        glProgramUniform3fv(id, glGetUniformLocation(id, "lightPos"), 1, glm::value_ptr(newLightPos));
+
+        // View
+        glProgramUniform3fv(id, glGetUniformLocation(id, "viewPos"), 1, glm::value_ptr(camera.Position));
+
+        id = lightShader->ID;
+        glProgramUniformMatrix4fv(id, glGetUniformLocation(id, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glProgramUniformMatrix4fv(id, glGetUniformLocation(id, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+
+        // queue the material cubes and the light, nearest first
+        // -----------------------------------------------------
+        unsigned int count;
+        const MaterialCube* cubes = materialCubes(&count);
+        queue.clear();
+        for (unsigned int i = 0; i < count; i++) {
+            float depth = -(view * glm::vec4(cubes[i].position, 1.0f)).z;
+            queue.submit(PASS_OPAQUE, ourShader->ID, 0, VAO, depth, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset(), i);
+        }
+        float lightDepth = -(view * glm::vec4(newLightPos, 1.0f)).z;
+        queue.submit(PASS_OPAQUE, lightShader->ID, 0, lightVAO, lightDepth, GL_TRIANGLES, cube.indexCount(), cube.indexType(), cube.indexOffset(), LIGHT_CUBE);
+
+        queue.execute([&](const RenderItem& item) {
+            glm::mat4 model = glm::mat4(1.0f);
+            if (item.user == LIGHT_CUBE) {
+                model = glm::translate(model, newLightPos);
+                model = glm::scale(model, glm::vec3(0.25f, 0.25f, 0.25f));
+                glUniformMatrix4fv(lightModelLoc, 1, GL_FALSE, glm::value_ptr(model));
+                return;
+            }
+            model = glm::translate(model, cubes[item.user].position);
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+            setMaterialColors(cubes[item.user]);
+        });
+    }
+
+    void shutdown() override
+    {
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        glDeleteVertexArrays(1, &VAO);
+        cube.destroy();
+    }
+
+    void setMaterialColors(const MaterialCube& material) {
+
+        glUniform3fv(ambientLoc, 1, glm::value_ptr(material.ambient));
+        glUniform3fv(diffuseLoc, 1, glm::value_ptr(material.diffuse));
+        glUniform3fv(specularLoc, 1, glm::value_ptr(material.specular));
+        glUniform1f(shininessLoc, material.shininess * 128.0f);
+
+    }
+};
@@ -11,9 +11,9 @@ uniform mat4 projection;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(model * vec4(decodePosition(aPos), 1.0));
     // Inversing a matrix is expensive in a shader and should be done on the CPU
-    Normal = mat3(transpose(inverse(model))) * aNormal;    
+    Normal = mat3(transpose(inverse(model))) * decodeNormal(aNormal);    
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,385 @@
+/*
+Hosts every ported demo as a scene inside one window and GL context.
+Scenes share the runner's resource cache, so a shader or texture used by several demos is
+compiled / uploaded once, and a scene that has been shown before is switched back to without
+reloading anything.
+
+    scene-runner                 Left / Right switch scenes
+    scene-runner --benchmark [frames]
+                                 runs every scene for `frames` frames (default 500) back to back
+                                 with vsync off and prints per-scene frame times; each scene is
+                                 shut down once the sweep has moved on and the mesh buffers are
+                                 compacted around the next one
+    scene-runner --headless [frames] [--capture dir]
+                                 the same sweep without a window (build with LEARNOPENGL_HEADLESS),
+                                 each frame advances one simulation step; --capture writes the last
+                                 frame of every scene to dir/<scene>.ppm
+    scene-runner ... --input-thread
+                                 renders on a thread of its own while the main thread only waits
+                                 for window events, so input isn't held up by long frames
+    scene-runner ... --vertex-pulling
+                                 meshes go into one storage buffer the vertex shaders fetch from,
+                                 instead of vertex attributes
+    scene-runner ... --lighting forward|clustered|deferred|tiled [--point-lights n]
+                                 how light-caster-multiple-lights shades its point lights: every
+                                 light per fragment (default), the lights of the fragment's
+                                 cluster, once per visible pixel from a G-buffer, or the lights
+                                 of the fragment's screen tile after a depth prepass (Forward+);
+                                 --point-lights adds n small moving lights to the scene
+    scene-runner ... --depth-prepass [--overdraw]
+                                 forward and clustered lighting lay down depth with a
+                                 position-only pass first and shade with GL_EQUAL; --overdraw
+                                 reports fragments shaded per visible pixel and the passes' GPU
+                                 time, with or without the prepass
+    scene-runner ... --lightmaps
+                                 light-caster-directional path-traces its static cubes' direct
+                                 and bounced light into a lightmap at load, on every core, and
+                                 draws them from it; the bake is reported
+    scene-runner ... --baked-vertex-lighting
+                                 lighting-specular-(gouraud)-rotating holds its light still and
+                                 draws the cube with ambient and diffuse baked into vertex colours
+    scene-runner ... --gpu-animation
+                                 light-caster-spotlight-(flashlight) uploads its cubes' rest
+                                 transforms and spin rates once and turns them in the vertex
+                                 shader from a time uniform
+*/
+#include <application.h>
+#include <lighting.h>
+#include <lightmapBaker.h>
+#include <overdraw.h>
+#include <shadowMaps.h>
+
+#include "../cube/scene.h"
+#include "../cube-many/scene.h"
+#include "../camera-rotate-around-scene/scene.h"
+#include "../camera-user-input/scene.h"
+#include "../lighting-ambient/scene.h"
+#include "../light-specular-(phong)-rotating/scene.h"
+#include "../lighting-specular-(phong-view-space)-rotating/scene.h"
+#include "../lighting-specular-(gouraud)-rotating/scene.h"
+#include "../materials/scene.h"
+#include "../materials-and-light-properties/scene.h"
+#include "../lighting-maps/scene.h"
+#include "../lighting-texture-maps-(coloured)/scene.h"
+#include "../light-texture-maps-(emmission-map)/scene.h"
+#include "../light-caster-directional/scene.h"
+#include "../light-caster-point/scene.h"
+#include "../light-caster-spotlight-(flashlight)/scene.h"
+#include "../light-caster-spotlight-(flashlight)-2/scene.h"
+#include "../light-caster-multiple-lights/scene.h"
+#include "../light-caster-multiple-lights-(desert)/scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+class SceneRunner : public Application
+{
+public:
+    // benchmarkFrames > 0 runs the benchmark sweep instead of the interactive runner
+    SceneRunner(int benchmarkFrames, const char* captureDir = NULL) : Application("scene-runner"), benchmarkFrames(benchmarkFrames), captureDir(captureDir)
+    {
+        add<Cube>("cube");
+        add<CubeMany>("cube-many");
+        add<CameraRotateAroundScene>("camera-rotate-around-scene");
+        add<CameraUserInput>("camera-user-input");
+        add<LightingAmbient>("lighting-ambient");
+        add<LightSpecularPhongRotating>("light-specular-(phong)-rotating");
+        add<LightingSpecularPhongViewSpaceRotating>("lighting-specular-(phong-view-space)-rotating");
+        add<LightingSpecularGouraudRotating>("lighting-specular-(gouraud)-rotating");
+        add<Materials>("materials");
+        add<MaterialsAndLightProperties>("materials-and-light-properties");
+        add<LightingMaps>("lighting-maps");
+        add<LightingTextureMapsColoured>("lighting-texture-maps-(coloured)");
+        add<LightTextureMapsEmissionMap>("light-texture-maps-(emmission-map)");
+        add<LightCasterDirectional>("light-caster-directional");
+        add<LightCasterPoint>("light-caster-point");
+        add<LightCasterSpotlight>("light-caster-spotlight-(flashlight)");
+        add<LightCasterSpotlight2>("light-caster-spotlight-(flashlight)-2");
+        add<LightCasterMultipleLights>("light-caster-multiple-lights");
+        add<LightCasterMultipleLightsDesert>("light-caster-multiple-lights-(desert)");
+    }
+
+    // frames in a whole benchmark sweep
+    unsigned int sweepFrames() const
+    {
+        return (unsigned int)(scenes.size() * benchmarkFrames);
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Scene {
+        const char* name;
+        std::unique_ptr<Application> app;
+        bool started = false;
+        // benchmark results, milliseconds
+        double switchTime = 0.0;
+        double totalTime = 0.0;
+        double minTime = 0.0;
+        double maxTime = 0.0;
+        int frames = 0;
+    };
+
+    template <typename T>
+    void add(const char* name)
+    {
+        Scene scene;
+        scene.name = name;
+        scene.app.reset(new T());
+        scenes.push_back(std::move(scene));
+    }
+
+    void init() override
+    {
+        if (benchmarkFrames > 0 && window != NULL) {
+            // measure the scenes, not the display refresh rate
+            glfwSwapInterval(0);
+        }
+        activate(0);
+    }
+
+    void frame() override
+    {
+        // keys for the runner itself are consumed here, everything else goes to the active scene
+        InputEvent event;
+        while (pollEvent(event)) {
+            if (benchmarkFrames == 0 && event.type == INPUT_KEY && event.action == GLFW_PRESS) {
+                if (event.key == GLFW_KEY_RIGHT) {
+                    activate((active + 1) % scenes.size());
+                    continue;
+                }
+                if (event.key == GLFW_KEY_LEFT) {
+                    activate((active + scenes.size() - 1) % scenes.size());
+                    continue;
+                }
+            }
+            scenes[active].app->postEvent(event);
+        }
+
+        Application& scene = *scenes[active].app;
+        // picks up framebuffer size changes
+        scene.attach(*this);
+        if (benchmarkFrames == 0) {
+            scene.frame();
+            return;
+        }
+
+        Clock::time_point start = Clock::now();
+        scene.frame();
+        glFinish();
+        record(scenes[active], milliseconds(start));
+        if (scenes[active].frames == benchmarkFrames) {
+            capture(scenes[active]);
+            if (active + 1 < scenes.size()) {
+                activate(active + 1);
+            } else {
+                report();
+                requestClose();
+            }
+        }
+    }
+
+    void shutdown() override
+    {
+        for (size_t i = 0; i < scenes.size(); i++) {
+            if (scenes[i].started) {
+                scenes[i].app->stop();
+            }
+        }
+    }
+
+    // makes scene `index` the one being shown, initialising it the first time
+    void activate(size_t index)
+    {
+        Clock::time_point start = Clock::now();
+        Scene& scene = scenes[index];
+        scene.app->attach(*this);
+        if (!scene.started) {
+            scene.app->start();
+            scene.started = true;
+        }
+        // don't simulate the time the scene spent hidden
+        scene.app->resume();
+        if (benchmarkFrames > 0 && index != active) {
+            // a sweep never comes back, so the outgoing scene's meshes can go
+            retire(scenes[active]);
+        }
+        if (benchmarkFrames > 0) {
+            glFinish();
+        }
+        active = index;
+        scene.switchTime = milliseconds(start);
+
+        if (window != NULL) {
+            glfwSetWindowTitle(window, scene.name);
+        }
+        if (benchmarkFrames == 0) {
+            std::cout << scene.name << ": switched in " << std::fixed << std::setprecision(2) << scene.switchTime << " ms"
+                << " (" << resources->shaderCount() << " shaders, " << resources->textureCount() << " textures cached)" << std::endl;
+        }
+    }
+
+    // shuts a scene down and compacts the mesh buffers it leaves holes in; the scenes still running
+    // point their VAOs at wherever their meshes moved
+    void retire(Scene& scene)
+    {
+        if (!scene.started) {
+            return;
+        }
+        scene.app->stop();
+        scene.started = false;
+        if (meshBuffers().defragment() > 0) {
+            MeshBuffer::refreshAll();
+        }
+    }
+
+    void record(Scene& scene, double time)
+    {
+        scene.minTime = scene.frames == 0 ? time : std::min(scene.minTime, time);
+        scene.maxTime = scene.frames == 0 ? time : std::max(scene.maxTime, time);
+        scene.totalTime += time;
+        scene.frames++;
+    }
+
+    void capture(const Scene& scene) const
+    {
+#ifdef LEARNOPENGL_HEADLESS
+        if (captureDir != NULL) {
+            HeadlessContext::writeImage((std::string(captureDir) + "/" + scene.name + ".ppm").c_str(), width, height);
+        }
+#endif
+    }
+
+    void report() const
+    {
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "scene, switch ms, avg ms, min ms, max ms" << std::endl;
+        double total = 0.0;
+        for (size_t i = 0; i < scenes.size(); i++) {
+            const Scene& scene = scenes[i];
+            std::cout << scene.name << ", " << scene.switchTime << ", " << scene.totalTime / scene.frames
+                << ", " << scene.minTime << ", " << scene.maxTime << std::endl;
+            total += scene.switchTime + scene.totalTime;
+        }
+        std::cout << scenes.size() << " scenes x " << benchmarkFrames << " frames in " << total << " ms; "
+            << resources->shaderCount() << " shaders and " << resources->textureCount() << " textures loaded, "
+            << resources->hitCount() << " cache hits / " << resources->missCount() << " misses" << std::endl;
+        std::cout << "frame data: " << (frameData->persistent() ? "persistent" : "glBufferSubData") << " ring of "
+            << RingBuffer::FRAMES << " x " << frameData->frameCapacity() / 1024 << " KB, " << frameData->lastFrameUsage()
+            << " bytes used in the last frame, " << frameData->stallCount() << " stalls" << std::endl;
+        const GLStateCounts& state = glState().lastFrame();
+        std::cout << "gl state: " << state.totalSkipped() << " of " << state.totalCalls() << " state calls skipped in the last frame ("
+            << state.skipped[STATE_PROGRAM] << " program, " << state.skipped[STATE_VERTEX_ARRAY] << " VAO, "
+            << state.skipped[STATE_BUFFER] << " buffer, " << state.skipped[STATE_TEXTURE] << " texture, "
+            << state.skipped[STATE_RENDER] << " depth / blend, " << state.skipped[STATE_VIEWPORT] << " viewport)" << std::endl;
+
+        VertexCacheStats before, after;
+        const Mesh& cube = cubeMesh(&before, &after);
+        VertexLayout packed(VertexFormat(), cube.floatsPerVertex);
+        std::cout << std::setprecision(2) << "cube mesh: " << cube.indices.size() << " -> " << cube.vertexCount() << " vertices, "
+            << cube.floatsPerVertex * sizeof(float) << " -> " << packed.stride << " bytes per vertex, "
+            << "ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+        BufferAllocatorStats meshes = meshBuffers().stats();
+        std::cout << "mesh buffers: " << meshes.requestedBytes << " bytes in " << meshes.buffers << " buffer(s) of "
+            << meshes.reservedBytes / 1024 << " KB, " << std::setprecision(1) << meshes.utilization() * 100.0 << "% used, "
+            << meshes.fragmentation() * 100.0 << "% of the free space fragmented, " << meshes.movedAllocations
+            << " allocations (" << meshes.movedBytes << " bytes) moved by defragmenting" << std::endl;
+        if (vertexPullPool().size() > 0) {
+            std::cout << "vertex pulling: " << vertexPullPool().size() << " bytes of vertices from " << vertexPullPool().meshCount()
+                << " meshes in one storage buffer" << std::endl;
+        }
+        if (shadowStats().layerFrames > 0) {
+            const ShadowStats& shadows = shadowStats();
+            std::cout << "shadow maps: " << shadows.staticRenders << " static and " << shadows.dynamicRenders << " moving-caster renders over "
+                << shadows.layerFrames << " cascade / cube face frames" << std::endl;
+        }
+        if (lightmapStats().width > 0) {
+            const LightmapStats& lightmap = lightmapStats();
+            std::cout << std::setprecision(1) << "lightmap: " << lightmap.width << " x " << lightmap.height << " texels in "
+                << lightmap.charts << " charts over " << lightmap.triangles << " triangles, " << lightmap.rays << " rays in "
+                << lightmap.milliseconds << " ms on " << lightmap.threads << " threads" << std::endl;
+        }
+        for (std::map<std::string, OverdrawStats>::const_iterator it = overdrawStats().begin(); it != overdrawStats().end(); ++it) {
+            const OverdrawStats& stats = it->second;
+            if (stats.frames == 0) {
+                continue;
+            }
+            std::cout << std::setprecision(2) << it->first << ": depth prepass " << (stats.depthPrepass ? "on" : "off") << ", "
+                << stats.overdraw() << " fragments shaded per visible pixel (" << stats.litFragments / stats.frames << " / "
+                << stats.visiblePixels / stats.frames << "), lit pass " << std::setprecision(3) << stats.litMilliseconds / stats.frames
+                << " ms + prepass " << stats.prepassMilliseconds / stats.frames << " ms a frame on the GPU" << std::endl;
+        }
+    }
+
+    static double milliseconds(Clock::time_point since)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    }
+
+    std::vector<Scene> scenes;
+    size_t active = 0;
+    int benchmarkFrames;
+    const char* captureDir;
+};
+
+int main(int argc, char* argv[])
+{
+    int benchmarkFrames = 0;
+    bool headless = false;
+    bool inputThread = false;
+    const char* captureDir = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--benchmark") == 0 || std::strcmp(argv[i], "--headless") == 0) {
+            headless = headless || std::strcmp(argv[i], "--headless") == 0;
+            benchmarkFrames = 500;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+                benchmarkFrames = std::atoi(argv[++i]);
+            }
+        } else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            captureDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--input-thread") == 0) {
+            inputThread = true;
+        } else if (std::strcmp(argv[i], "--vertex-pulling") == 0) {
+            MeshBuffer::setVertexPulling(true);
+        } else if (std::strcmp(argv[i], "--lighting") == 0 && i + 1 < argc) {
+            i++;
+            if (std::strcmp(argv[i], "clustered") == 0) {
+                lightingOptions().path = LIGHTING_CLUSTERED;
+            } else if (std::strcmp(argv[i], "deferred") == 0) {
+                lightingOptions().path = LIGHTING_DEFERRED;
+            } else if (std::strcmp(argv[i], "tiled") == 0) {
+                lightingOptions().path = LIGHTING_TILED;
+            } else if (std::strcmp(argv[i], "forward") != 0) {
+                std::cout << "unknown lighting path " << argv[i] << ", using forward" << std::endl;
+            }
+        } else if (std::strcmp(argv[i], "--depth-prepass") == 0) {
+            lightingOptions().depthPrepass = true;
+        } else if (std::strcmp(argv[i], "--overdraw") == 0) {
+            lightingOptions().measureOverdraw = true;
+        } else if (std::strcmp(argv[i], "--lightmaps") == 0) {
+            lightingOptions().lightmaps = true;
+        } else if (std::strcmp(argv[i], "--baked-vertex-lighting") == 0) {
+            lightingOptions().bakedVertexLighting = true;
+        } else if (std::strcmp(argv[i], "--gpu-animation") == 0) {
+            lightingOptions().gpuAnimation = true;
+        } else if (std::strcmp(argv[i], "--point-lights") == 0 && i + 1 < argc) {
+            lightingOptions().extraPointLights = (unsigned int)std::atoi(argv[++i]);
+        }
+    }
+
+    SceneRunner app(benchmarkFrames, captureDir);
+    if (headless) {
+#ifdef LEARNOPENGL_HEADLESS
+        return app.runHeadless(app.sweepFrames());
+#else
+        std::cout << "scene-runner was built without LEARNOPENGL_HEADLESS" << std::endl;
+        return -1;
+#endif
+    }
+    return app.run(inputThread);
+}
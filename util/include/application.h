@@ -0,0 +1,427 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <shader.h>
+#include <camera.h>
+#include <inputQueue.h>
+#include <frameLoop.h>
+#include <resourceCache.h>
+#include <glExtensions.h>
+#include <ringBuffer.h>
+#include <glState.h>
+
+#ifdef LEARNOPENGL_HEADLESS
+#include <headlessContext.h>
+#endif
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Owns the window, GL context, input and frame loop shared by every demo.
+// A demo derives from Application, overrides the hooks it needs and calls run() from main
+// (or runHeadless() on a machine without a display, see headlessContext.h):
+//   init()             once, after the context is current
+//   update(step)       at a fixed simulation rate (FrameLoop::step seconds per call)
+//   render(alpha)      once per displayed frame, alpha blends the previous and current simulation state
+//   shutdown()         once, before the context is destroyed
+// An application can also be hosted inside another one's window and context (see attach()).
+// run(true) renders on a thread of its own while the main thread does nothing but wait for window
+// events and queue them, so input keeps arriving while a frame or a swap blocks.
+class Application
+{
+public:
+    Application(const char* title = "LearnOpenGL", unsigned int width = 800, unsigned int height = 600) : title(title), width(width), height(height)
+    {
+    }
+    virtual ~Application() {}
+
+    // creates the window, runs the frame loop until the window is closed and tears everything down;
+    // with inputThread the frame loop runs on a render thread (see renderOnOwnThread)
+    int run(bool inputThread = false)
+    {
+        // glfw: initialize and configure
+        // ------------------------------
+        glfwInit();
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        // glfw window creation
+        // --------------------
+        window = glfwCreateWindow(width, height, title, NULL, NULL);
+        if (window == NULL)
+        {
+            std::cout << "Failed to create GLFW window" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(window);
+        glfwSetWindowUserPointer(window, this);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        glfwSetKeyCallback(window, key_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+
+        // glad: load all OpenGL function pointers
+        // ---------------------------------------
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+        glState().install();
+
+        init();
+
+        // render loop
+        // -----------
+        if (inputThread) {
+            renderOnOwnThread();
+        } else {
+            while (!glfwWindowShouldClose(window))
+            {
+                frameData->beginFrame();
+                frame();
+                frameData->endFrame();
+                glState().endFrame();
+
+                // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+                // -------------------------------------------------------------------------------
+                glfwSwapBuffers(window);
+                glfwPollEvents();
+            }
+        }
+
+        shutdown();
+        resources->clear();
+        frameData->destroy();
+
+        // glfw: terminate, clearing all previously allocated GLFW resources.
+        // ------------------------------------------------------------------
+        glfwTerminate();
+        return 0;
+    }
+
+#ifdef LEARNOPENGL_HEADLESS
+    // renders `frames` frames into an offscreen framebuffer with no window, advancing exactly one
+    // simulation step per frame so the output is reproducible; optionally saves the last frame as a PPM
+    int runHeadless(unsigned int frames, const char* capturePath = NULL)
+    {
+        HeadlessContext context;
+        if (!context.create(width, height))
+        {
+            std::cout << "Failed to create headless OpenGL context" << std::endl;
+            return -1;
+        }
+        if (!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress))
+        {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
+        loadGLExtensions((GLADloadproc)HeadlessContext::getProcAddress);
+        glState().install();
+        context.createFramebuffer(width, height);
+        frameLoop.setFixedFrameTime(frameLoop.step());
+
+        init();
+        for (unsigned int i = 0; i < frames && !closeRequested; i++)
+        {
+            frameData->beginFrame();
+            frame();
+            frameData->endFrame();
+            glState().endFrame();
+        }
+        glFinish();
+        if (capturePath != NULL) {
+            HeadlessContext::writeImage(capturePath, width, height);
+        }
+
+        shutdown();
+        resources->clear();
+        frameData->destroy();
+        return 0;
+    }
+#endif
+
+    // hosting: share `host`'s window, context, resource cache and frame data instead of creating our own.
+    // Call before start() and again whenever the host's framebuffer size changes.
+    void attach(Application& host)
+    {
+        window = host.window;
+        resources = host.resources;
+        frameData = host.frameData;
+        width = host.width;
+        height = host.height;
+        frameLoop.setFixedFrameTime(host.frameLoop.getFixedFrameTime());
+    }
+
+    // hosting: run init() / shutdown() on the host's context
+    void start()
+    {
+        init();
+    }
+
+    void stop()
+    {
+        shutdown();
+    }
+
+    // hosting: hand over an event the host received; it is applied at the start of our next frame
+    void postEvent(const InputEvent& event)
+    {
+        inputQueue.push(event, event.type == INPUT_KEY ? 0 : INPUT_KEY_RESERVE);
+    }
+
+    // runs one frame: input, any due simulation steps, then rendering
+    virtual void frame()
+    {
+        frameLoop.beginFrame();
+        InputEvent event;
+        while (pollEvent(event)) {
+            applyEvent(event);
+        }
+        processInput((float)frameLoop.frameDelta());
+        while (frameLoop.shouldStep()) {
+            update(frameLoop.step());
+        }
+        render(frameLoop.alpha());
+    }
+
+    // hosting: the next frame starts from now rather than from when this application was last shown
+    void resume()
+    {
+        frameLoop.resume();
+    }
+
+    const char* getTitle() const { return title; }
+
+protected:
+    virtual void init() {}
+    virtual void update(double step) {}
+    virtual void render(double alpha) {}
+    virtual void shutdown() {}
+
+    // called once per frame before any simulation step; the default flies the camera with WASD and the mouse
+    virtual void processInput(float deltaTime)
+    {
+        if (isKeyHeld(GLFW_KEY_ESCAPE)) {
+            requestClose();
+        }
+        if (!cameraControls) {
+            return;
+        }
+        if (isKeyHeld(GLFW_KEY_W)) {
+            camera.ProcessKeyboard(FORWARD, deltaTime);
+        }
+        if (isKeyHeld(GLFW_KEY_S)) {
+            camera.ProcessKeyboard(BACKWARD, deltaTime);
+        }
+        if (isKeyHeld(GLFW_KEY_A)) {
+            camera.ProcessKeyboard(LEFT, deltaTime);
+        }
+        if (isKeyHeld(GLFW_KEY_D)) {
+            camera.ProcessKeyboard(RIGHT, deltaTime);
+        }
+    }
+
+    // ends run() / runHeadless() after the current frame
+    void requestClose()
+    {
+        closeRequested = true;
+        if (window != NULL) {
+            glfwSetWindowShouldClose(window, true);
+            // wakes the main thread's glfwWaitEvents when rendering on a thread of its own
+            glfwPostEmptyEvent();
+        }
+    }
+
+    bool isKeyHeld(int key) const
+    {
+        return key >= 0 && key <= GLFW_KEY_LAST && keysHeld[key];
+    }
+
+    // simulation time at the instant being rendered; animation that is a pure function of time
+    // can use this instead of keeping previous/current state
+    double renderTime() const
+    {
+        return frameLoop.simulationTime() - frameLoop.step() * (1.0 - frameLoop.alpha());
+    }
+
+    glm::mat4 projectionMatrix(float fov = 45.0f) const
+    {
+        float aspect = height > 0 ? (float)width / (float)height : 1.0f;
+        return glm::perspective(glm::radians(fov), aspect, 0.1f, 100.0f);
+    }
+
+    // shaders and textures come from the (possibly shared) cache and live as long as the context.
+    // Vertex shaders reading a MeshBuffer get its decode functions as vertexHeader.
+    Shader* loadShader(const char* vertexPath, const char* fragmentPath, const std::string& vertexHeader = std::string())
+    {
+        return resources->shader(vertexPath, fragmentPath, vertexHeader);
+    }
+
+    unsigned int loadTexture(const std::string& filename, bool flipVertically = false)
+    {
+        return resources->texture(filename, flipVertically);
+    }
+
+    // next event queued by the GLFW callbacks (or postEvent) since the last call
+    bool pollEvent(InputEvent& event)
+    {
+        return inputQueue.pop(event);
+    }
+
+    // applies a queued event to the held-key state and the camera
+    void applyEvent(const InputEvent& event)
+    {
+        switch (event.type) {
+        case INPUT_KEY:
+            if (event.key >= 0 && event.key <= GLFW_KEY_LAST) {
+                keysHeld[event.key] = event.action != GLFW_RELEASE;
+            }
+            break;
+        case INPUT_CURSOR:
+            applyCursor(static_cast<float>(event.x), static_cast<float>(event.y));
+            break;
+        case INPUT_SCROLL:
+            if (cameraControls) {
+                camera.ProcessMouseScroll(static_cast<float>(event.y));
+            }
+            break;
+        }
+    }
+
+    const char* title;
+    unsigned int width;
+    unsigned int height;
+    // NULL when running headless
+    GLFWwindow* window = NULL;
+    Camera camera;
+    // demos with a scripted view turn this off so mouse and WASD leave the camera alone
+    bool cameraControls = true;
+    FrameLoop frameLoop;
+    ResourceCache ownResources;
+    ResourceCache* resources = &ownResources;
+    // per-frame uniform / instance data, valid until the end of the frame it was allocated in
+    RingBuffer ownFrameData;
+    RingBuffer* frameData = &ownFrameData;
+
+private:
+    // run(true)'s frame loop. The context moves to a render thread, which runs frames and swaps until
+    // the window is closed; this thread blocks in glfwWaitEvents and the callbacks push to the input
+    // queue from here, the queue's one producer, while frame() pops on the render thread. Resizes are
+    // handed over through pendingFramebufferSize, as glViewport needs the context.
+    void renderOnOwnThread()
+    {
+        std::atomic<bool> rendering(true);
+        renderThreadRunning = true;
+        glfwMakeContextCurrent(NULL);
+        std::thread renderer([this, &rendering] {
+            glfwMakeContextCurrent(window);
+            while (rendering.load(std::memory_order_acquire) && !closeRequested) {
+                applyFramebufferSize();
+                frameData->beginFrame();
+                frame();
+                frameData->endFrame();
+                glState().endFrame();
+                glfwSwapBuffers(window);
+            }
+            glfwMakeContextCurrent(NULL);
+        });
+        while (!glfwWindowShouldClose(window)) {
+            glfwWaitEvents();
+        }
+        rendering.store(false, std::memory_order_release);
+        renderer.join();
+        renderThreadRunning = false;
+        // shutdown() runs here
+        glfwMakeContextCurrent(window);
+    }
+
+    // render thread: the framebuffer size the last resize on the main thread left
+    void applyFramebufferSize()
+    {
+        unsigned long long size = pendingFramebufferSize.exchange(0, std::memory_order_acquire);
+        if (size != 0) {
+            width = (unsigned int)(size >> 32) & 0x7FFFFFFFu;
+            height = (unsigned int)size;
+            glViewport(0, 0, width, height);
+        }
+    }
+
+    void applyCursor(float xpos, float ypos)
+    {
+        if (firstMouse)
+        {
+            lastX = xpos;
+            lastY = ypos;
+            firstMouse = false;
+        }
+
+        float xoffset = xpos - lastX;
+        float yoffset = lastY - ypos; // reversed since y-coordinates go from bottom to top
+
+        lastX = xpos;
+        lastY = ypos;
+
+        if (cameraControls) {
+            camera.ProcessMouseMovement(xoffset, yoffset);
+        }
+    }
+
+    static Application* owner(GLFWwindow* window)
+    {
+        return static_cast<Application*>(glfwGetWindowUserPointer(window));
+    }
+
+    // GLFW callbacks only record events; they are applied at the start of the next frame
+    static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+    {
+        owner(window)->inputQueue.push({ INPUT_KEY, key, action, 0.0, 0.0 });
+    }
+
+    static void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
+    {
+        owner(window)->inputQueue.push({ INPUT_CURSOR, 0, 0, xposIn, yposIn }, INPUT_KEY_RESERVE);
+    }
+
+    static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+    {
+        owner(window)->inputQueue.push({ INPUT_SCROLL, 0, 0, xoffset, yoffset }, INPUT_KEY_RESERVE);
+    }
+
+    // glfw: whenever the window size changed (by OS or user resize) this callback function executes
+    static void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+    {
+        if (owner(window)->renderThreadRunning) {
+            // no context on this thread; the top bit tells a pending 0 x 0 (minimised) from none
+            owner(window)->pendingFramebufferSize.store(1ull << 63 | (unsigned long long)width << 32 | (unsigned int)height, std::memory_order_release);
+            return;
+        }
+        // make sure the viewport matches the new window dimensions; note that width and
+        // height will be significantly larger than specified on retina displays.
+        glViewport(0, 0, width, height);
+        owner(window)->width = width;
+        owner(window)->height = height;
+    }
+
+    InputQueue inputQueue;
+    bool closeRequested = false;
+    // run(true): set while the render thread has the context, and the size it has yet to apply
+    bool renderThreadRunning = false;
+    std::atomic<unsigned long long> pendingFramebufferSize{ 0 };
+    bool keysHeld[GLFW_KEY_LAST + 1] = {};
+    bool firstMouse = true;
+    float lastX = 400.0f;
+    float lastY = 300.0f;
+};
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glExtensions.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <set>
+#include <vector>
+
+// where an allocation currently lives
+struct BufferRange {
+    unsigned int buffer = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+};
+
+struct BufferAllocatorStats {
+    size_t buffers = 0;
+    // bytes of GL storage, of power-of-two blocks handed out, and of what was asked for
+    size_t reservedBytes = 0;
+    size_t allocatedBytes = 0;
+    size_t requestedBytes = 0;
+    size_t largestFreeBlock = 0;
+    // what defragment() has copied so far
+    size_t movedAllocations = 0;
+    size_t movedBytes = 0;
+
+    // share of the reserved storage holding data
+    double utilization() const
+    {
+        return reservedBytes > 0 ? (double)requestedBytes / reservedBytes : 0.0;
+    }
+
+    // 0 when all free space is one block, towards 1 the more it is split up
+    double fragmentation() const
+    {
+        size_t free = reservedBytes - allocatedBytes;
+        return free > 0 ? 1.0 - (double)largestFreeBlock / free : 0.0;
+    }
+};
+
+// Hands out ranges of a few large immutable buffers (glBufferStorage where available) instead of one
+// buffer object per mesh. Each buffer ("page") is split with a buddy allocator: blocks are powers of
+// two from MIN_BLOCK up, aligned to their size, and a freed block merges with its free buddy. Anything
+// larger than a page gets a page of its own.
+//
+//     unsigned int vertices = allocator.allocate(bytes, data);
+//     BufferRange range = allocator.range(vertices);     // buffer + offset to bind
+//     allocator.free(vertices);
+//
+// defragment() moves allocations out of the emptiest pages into the others and deletes the pages it
+// empties. Handles stay valid, but anything that captured a moved range (a VAO, an index offset) has to
+// fetch it again; generation() changes whenever that is necessary.
+class BufferAllocator
+{
+public:
+    static const size_t MIN_BLOCK = 256;
+    static const size_t DEFAULT_PAGE_SIZE = 1024 * 1024;
+
+    explicit BufferAllocator(size_t pageSize = DEFAULT_PAGE_SIZE) : pageSize(roundUp(pageSize))
+    {
+    }
+
+    // returns a handle, never 0; `data` may be NULL to leave the range undefined
+    unsigned int allocate(size_t bytes, const void* data = NULL)
+    {
+        unsigned int order = orderFor(bytes);
+        Block block;
+        if (!allocateBlock(order, (size_t)-1, block)) {
+            size_t page = createPage(std::max(pageSize, MIN_BLOCK << order));
+            allocateBlock(order, page, block);
+        }
+
+        unsigned int handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            allocations.push_back(Allocation());
+            handle = (unsigned int)allocations.size() - 1;
+        }
+        Allocation& allocation = allocations[handle];
+        allocation.page = block.page;
+        allocation.offset = block.offset;
+        allocation.order = order;
+        allocation.size = bytes;
+        allocation.live = true;
+        requested += bytes;
+
+        if (data != NULL && bytes > 0) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, pages[block.page].buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, block.offset, bytes, data);
+        }
+        return handle + 1;
+    }
+
+    void free(unsigned int handle)
+    {
+        if (handle == 0 || handle > allocations.size() || !allocations[handle - 1].live) {
+            return;
+        }
+        Allocation& allocation = allocations[handle - 1];
+        freeBlock(allocation.page, allocation.offset, allocation.order);
+        requested -= allocation.size;
+        allocation.live = false;
+        freeHandles.push_back(handle - 1);
+    }
+
+    BufferRange range(unsigned int handle) const
+    {
+        BufferRange range;
+        if (handle == 0 || handle > allocations.size() || !allocations[handle - 1].live) {
+            return range;
+        }
+        const Allocation& allocation = allocations[handle - 1];
+        range.buffer = pages[allocation.page].buffer;
+        range.offset = (GLintptr)allocation.offset;
+        range.size = (GLsizeiptr)allocation.size;
+        return range;
+    }
+
+    // Moves the allocations of the least used pages into free blocks of fuller ones, copying on the GPU,
+    // and deletes the pages that end up empty. Returns how many allocations moved.
+    size_t defragment()
+    {
+        std::vector<size_t> order;
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (pages[i].buffer != 0) {
+                order.push_back(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return pages[a].used < pages[b].used; });
+
+        // the emptiest pages are evacuated as long as what they hold fits in the free space of the rest,
+        // so nothing moves twice
+        size_t evacuated = 0;
+        size_t movingBytes = 0;
+        size_t freeBytes = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            freeBytes += pages[order[i]].size - pages[order[i]].used;
+        }
+        std::vector<bool> evacuating(pages.size(), false);
+        while (evacuated + 1 < order.size()) {
+            const Page& page = pages[order[evacuated]];
+            if (movingBytes + page.used > freeBytes - (page.size - page.used)) {
+                break;
+            }
+            movingBytes += page.used;
+            freeBytes -= page.size - page.used;
+            evacuating[order[evacuated++]] = true;
+        }
+
+        size_t moved = 0;
+        for (size_t i = 0; i < allocations.size(); i++) {
+            Allocation& allocation = allocations[i];
+            if (!allocation.live || !evacuating[allocation.page]) {
+                continue;
+            }
+            size_t page = allocation.page;
+            // fullest pages first, to keep the free space of the others in one piece
+            Block block;
+            bool placed = false;
+            for (size_t target = order.size(); target-- > evacuated && !placed;) {
+                placed = allocateBlock(allocation.order, order[target], block);
+            }
+            if (!placed) {
+                continue;
+            }
+            glBindBuffer(GL_COPY_READ_BUFFER, pages[page].buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, pages[block.page].buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.offset, block.offset, allocation.size);
+            freeBlock(page, allocation.offset, allocation.order);
+            allocation.page = block.page;
+            allocation.offset = block.offset;
+            moved++;
+            totalMovedBytes += allocation.size;
+        }
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (pages[i].buffer != 0 && pages[i].used == 0) {
+                deletePage(i);
+            }
+        }
+        if (moved > 0) {
+            movedGeneration++;
+        }
+        totalMoved += moved;
+        return moved;
+    }
+
+    unsigned long long generation() const { return movedGeneration; }
+
+    BufferAllocatorStats stats() const
+    {
+        BufferAllocatorStats stats;
+        for (size_t i = 0; i < pages.size(); i++) {
+            const Page& page = pages[i];
+            if (page.buffer == 0) {
+                continue;
+            }
+            stats.buffers++;
+            stats.reservedBytes += page.size;
+            stats.allocatedBytes += page.used;
+            for (size_t order = page.free.size(); order-- > 0;) {
+                if (!page.free[order].empty()) {
+                    stats.largestFreeBlock = std::max(stats.largestFreeBlock, MIN_BLOCK << order);
+                    break;
+                }
+            }
+        }
+        stats.requestedBytes = requested;
+        stats.movedAllocations = totalMoved;
+        stats.movedBytes = totalMovedBytes;
+        return stats;
+    }
+
+    void destroy()
+    {
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (pages[i].buffer != 0) {
+                glDeleteBuffers(1, &pages[i].buffer);
+            }
+        }
+        pages.clear();
+        allocations.clear();
+        freeHandles.clear();
+        requested = 0;
+    }
+
+private:
+    struct Page {
+        unsigned int buffer = 0;
+        size_t size = 0;
+        size_t used = 0;
+        // offsets of the free blocks of each order, block size MIN_BLOCK << order
+        std::vector<std::set<size_t>> free;
+    };
+
+    struct Allocation {
+        size_t page = 0;
+        size_t offset = 0;
+        unsigned int order = 0;
+        size_t size = 0;
+        bool live = false;
+    };
+
+    struct Block {
+        size_t page = 0;
+        size_t offset = 0;
+    };
+
+    static size_t roundUp(size_t bytes)
+    {
+        size_t size = MIN_BLOCK;
+        while (size < bytes) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    static unsigned int orderFor(size_t bytes)
+    {
+        unsigned int order = 0;
+        while ((MIN_BLOCK << order) < bytes) {
+            order++;
+        }
+        return order;
+    }
+
+    // splits the smallest free block that fits, in `onlyPage` or in any page when it is -1
+    bool allocateBlock(unsigned int order, size_t onlyPage, Block& block)
+    {
+        for (size_t p = 0; p < pages.size(); p++) {
+            Page& page = pages[p];
+            if (page.buffer == 0 || (onlyPage != (size_t)-1 && p != onlyPage)) {
+                continue;
+            }
+            unsigned int found = order;
+            while (found < page.free.size() && page.free[found].empty()) {
+                found++;
+            }
+            if (found >= page.free.size()) {
+                continue;
+            }
+            size_t offset = *page.free[found].begin();
+            page.free[found].erase(page.free[found].begin());
+            // the upper halves of what is split off stay free
+            while (found > order) {
+                found--;
+                page.free[found].insert(offset + (MIN_BLOCK << found));
+            }
+            page.used += MIN_BLOCK << order;
+            block.page = p;
+            block.offset = offset;
+            return true;
+        }
+        return false;
+    }
+
+    void freeBlock(size_t p, size_t offset, unsigned int order)
+    {
+        Page& page = pages[p];
+        page.used -= MIN_BLOCK << order;
+        while (order + 1 < page.free.size()) {
+            size_t buddy = offset ^ (MIN_BLOCK << order);
+            std::set<size_t>::iterator it = page.free[order].find(buddy);
+            if (it == page.free[order].end()) {
+                break;
+            }
+            page.free[order].erase(it);
+            offset = std::min(offset, buddy);
+            order++;
+        }
+        page.free[order].insert(offset);
+    }
+
+    size_t createPage(size_t size)
+    {
+        size_t p = 0;
+        while (p < pages.size() && pages[p].buffer != 0) {
+            p++;
+        }
+        if (p == pages.size()) {
+            pages.push_back(Page());
+        }
+        Page& page = pages[p];
+        page.size = size;
+        page.used = 0;
+        page.free.assign(orderFor(size) + 1, std::set<size_t>());
+        page.free.back().insert(0);
+
+        glGenBuffers(1, &page.buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, page.buffer);
+        if (glExtensions().bufferStorage != NULL) {
+            glExtensions().bufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, GL_DYNAMIC_STORAGE_BIT);
+        } else {
+            glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STATIC_DRAW);
+        }
+        return p;
+    }
+
+    void deletePage(size_t p)
+    {
+        glDeleteBuffers(1, &pages[p].buffer);
+        pages[p] = Page();
+    }
+
+    size_t pageSize;
+    std::vector<Page> pages;
+    std::vector<Allocation> allocations;
+    std::vector<unsigned int> freeHandles;
+    size_t requested = 0;
+    unsigned long long movedGeneration = 0;
+    size_t totalMoved = 0;
+    size_t totalMovedBytes = 0;
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <lighting.h>
+#include <shader.h>
+
+#include <cmath>
+#include <string>
+
+// Storage bindings of the cluster lists: per cluster an (offset, count) pair into the light index list
+const unsigned int LIGHT_GRID_BINDING = 2;
+const unsigned int LIGHT_INDEX_BINDING = 3;
+
+// Clustered forward shading. The view frustum is cut into TILES_X x TILES_Y screen tiles and SLICES
+// depth slices, spaced exponentially between the near and far plane so clusters stay roughly cubic.
+// A compute shader gives every cluster the list of lights whose range sphere touches its bounds, and
+// fragments only shade the lights of the cluster they fall in, so the cost per fragment follows how
+// many lights actually reach it rather than how many the scene has.
+//
+//     RingBuffer::bindStorage(POINT_LIGHTS_BINDING, frameData->upload(lights, bytes, frameData->storageAlignment()));
+//     clusters.assign(view, projection, lightCount);        // binds its own program
+//     clusters.setUniforms(shader, width, height);         // once per frame, before the draws
+//
+// The fragment side of the lookup (see light-caster-multiple-lights/shader.fs) finds its cluster from
+// gl_FragCoord; a clusterGrid uniform of zero means "every light", the plain forward path.
+class ClusteredLighting
+{
+public:
+    static const unsigned int TILES_X = 16;
+    static const unsigned int TILES_Y = 9;
+    static const unsigned int SLICES = 24;
+    static const unsigned int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+    // lights past this many in one cluster are dropped
+    static const unsigned int MAX_LIGHTS_PER_CLUSTER = 256;
+
+    void init()
+    {
+        assignProgram = compileAssignProgram();
+        glGenBuffers(1, &gridBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, gridBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, CLUSTER_COUNT * 2 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+        glGenBuffers(1, &indexBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+    }
+
+    // bins the `lightCount` lights bound at POINT_LIGHTS_BINDING into the clusters of this view
+    void assign(const glm::mat4& view, const glm::mat4& projection, unsigned int lightCount)
+    {
+        // a perspective projection keeps both planes in its third column
+        nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+        farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+
+        glUseProgram(assignProgram);
+        glm::mat4 inverseProjection = glm::inverse(projection);
+        glUniformMatrix4fv(glGetUniformLocation(assignProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(assignProgram, "inverseProjection"), 1, GL_FALSE, glm::value_ptr(inverseProjection));
+        glUniform2f(glGetUniformLocation(assignProgram, "depthRange"), nearPlane, farPlane);
+        glUniform1ui(glGetUniformLocation(assignProgram, "lightCount"), lightCount);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_GRID_BINDING, gridBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_BINDING, indexBuffer);
+        glDispatchCompute((CLUSTER_COUNT + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+        // the fragment shaders read the lists next
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    // the lookup uniforms of a shader that reads the lists; `width` x `height` is the framebuffer
+    void setUniforms(unsigned int program, unsigned int width, unsigned int height) const
+    {
+        glProgramUniform3ui(program, glGetUniformLocation(program, "clusterGrid"), TILES_X, TILES_Y, SLICES);
+        glProgramUniform2f(program, glGetUniformLocation(program, "clusterScale"), (float)TILES_X / width, (float)TILES_Y / height);
+        glProgramUniform3f(program, glGetUniformLocation(program, "clusterDepth"), nearPlane, farPlane,
+            SLICES / std::log(farPlane / nearPlane));
+    }
+
+    void destroy()
+    {
+        unsigned int buffers[] = { gridBuffer, indexBuffer };
+        glDeleteBuffers(2, buffers);
+        gridBuffer = indexBuffer = 0;
+        glDeleteProgram(assignProgram);
+        assignProgram = 0;
+    }
+
+private:
+    static const unsigned int WORKGROUP_SIZE = 128;
+
+    static unsigned int compileAssignProgram()
+    {
+        std::string source = std::string("#version 430 core\n")
+            + "const uvec3 GRID = uvec3(" + std::to_string(TILES_X) + "u, " + std::to_string(TILES_Y) + "u, " + std::to_string(SLICES) + "u);\n"
+            + "const uint MAX_LIGHTS = " + std::to_string(MAX_LIGHTS_PER_CLUSTER) + "u;\n"
+            + "const uint BATCH = " + std::to_string(WORKGROUP_SIZE) + "u;\n"
+            + "layout (local_size_x = " + std::to_string(WORKGROUP_SIZE) + ") in;\n"
+            + "layout (std430, binding = " + std::to_string(POINT_LIGHTS_BINDING) + ") readonly buffer PointLights { vec4 pointLights[]; };\n"
+            + "layout (std430, binding = " + std::to_string(LIGHT_GRID_BINDING) + ") writeonly buffer LightGrid { uvec2 lightGrid[]; };\n"
+            + "layout (std430, binding = " + std::to_string(LIGHT_INDEX_BINDING) + ") writeonly buffer LightIndices { uint lightIndices[]; };\n"
+            + R"(
+uniform mat4 view;
+uniform mat4 inverseProjection;
+uniform vec2 depthRange;
+uniform uint lightCount;
+
+// view-space spheres of the batch of lights being tested, shared by the work group
+shared vec4 spheres[BATCH];
+
+// the point of the near plane under an NDC corner, scaled out to view depth `depth`
+vec3 cornerAt(vec2 ndc, float depth)
+{
+    vec4 p = inverseProjection * vec4(ndc, -1.0, 1.0);
+    p /= p.w;
+    return p.xyz * (depth / -p.z);
+}
+
+void main()
+{
+    uint cluster = gl_GlobalInvocationID.x;
+    bool inGrid = cluster < GRID.x * GRID.y * GRID.z;
+
+    // cluster bounds in view space
+    uvec3 cell = uvec3(cluster % GRID.x, (cluster / GRID.x) % GRID.y, cluster / (GRID.x * GRID.y));
+    vec2 low = vec2(cell.xy) / vec2(GRID.xy) * 2.0 - 1.0;
+    vec2 high = vec2(cell.xy + 1u) / vec2(GRID.xy) * 2.0 - 1.0;
+    float ratio = depthRange.y / depthRange.x;
+    float nearDepth = depthRange.x * pow(ratio, float(cell.z) / float(GRID.z));
+    float farDepth = depthRange.x * pow(ratio, float(cell.z + 1u) / float(GRID.z));
+    vec3 boundsMin = vec3(1e30);
+    vec3 boundsMax = vec3(-1e30);
+    for (int i = 0; i < 4; i++) {
+        vec2 corner = vec2((i & 1) != 0 ? high.x : low.x, (i & 2) != 0 ? high.y : low.y);
+        vec3 a = cornerAt(corner, nearDepth);
+        vec3 b = cornerAt(corner, farDepth);
+        boundsMin = min(boundsMin, min(a, b));
+        boundsMax = max(boundsMax, max(a, b));
+    }
+
+    uint first = cluster * MAX_LIGHTS;
+    uint count = 0u;
+    for (uint batch = 0u; batch < lightCount; batch += BATCH) {
+        // each invocation brings one light of the batch into view space; a PointLight is four vec4s
+        uint light = batch + gl_LocalInvocationID.x;
+        if (light < lightCount) {
+            vec4 position = pointLights[light * 4u];
+            spheres[gl_LocalInvocationID.x] = vec4(vec3(view * vec4(position.xyz, 1.0)), position.w);
+        }
+        barrier();
+
+        uint batchSize = min(BATCH, lightCount - batch);
+        for (uint i = 0u; inGrid && i < batchSize; i++) {
+            vec4 sphere = spheres[i];
+            vec3 closest = clamp(sphere.xyz, boundsMin, boundsMax);
+            vec3 offset = closest - sphere.xyz;
+            if (dot(offset, offset) <= sphere.w * sphere.w && count < MAX_LIGHTS) {
+                lightIndices[first + count] = batch + i;
+                count++;
+            }
+        }
+        barrier();
+    }
+    if (inGrid) {
+        lightGrid[cluster] = uvec2(first, count);
+    }
+}
+)";
+        return compileComputeProgram(source);
+    }
+
+    unsigned int assignProgram = 0;
+    unsigned int gridBuffer = 0;
+    unsigned int indexBuffer = 0;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+};
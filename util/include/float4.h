@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FLOAT4_SSE 1
+#endif
+
+// Four floats in one SSE register, or four plain floats without SSE: the lanes the CPU bakers work in
+// (LightmapBaker, VertexLightBaker). Comparisons give all-ones lanes for select4 and mask4.
+struct Float4 {
+#ifdef FLOAT4_SSE
+    __m128 v;
+    Float4() : v(_mm_setzero_ps()) {}
+    Float4(__m128 value) : v(value) {}
+    explicit Float4(float f) : v(_mm_set1_ps(f)) {}
+    static Float4 load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+#else
+    float v[4];
+    Float4() { v[0] = v[1] = v[2] = v[3] = 0.0f; }
+    explicit Float4(float f) { v[0] = v[1] = v[2] = v[3] = f; }
+    static Float4 load(const float* p) { Float4 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+    void store(float* p) const { std::memcpy(p, v, sizeof(v)); }
+#endif
+};
+
+#ifdef FLOAT4_SSE
+inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+inline Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+inline Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.v, b.v); }
+inline Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+inline Float4 operator<=(Float4 a, Float4 b) { return _mm_cmple_ps(a.v, b.v); }
+inline Float4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline Float4 min4(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+inline Float4 abs4(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline Float4 sqrt4(Float4 a) { return _mm_sqrt_ps(a.v); }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+// bit i set when lane i of a comparison is true
+inline int mask4(Float4 m) { return _mm_movemask_ps(m.v); }
+#else
+inline Float4 lanes4(Float4 a, Float4 b, float (*f)(float, float))
+{
+    Float4 r;
+    for (int i = 0; i < 4; i++) {
+        r.v[i] = f(a.v[i], b.v[i]);
+    }
+    return r;
+}
+inline float trueLane() { unsigned int bits = 0xFFFFFFFFu; float f; std::memcpy(&f, &bits, 4); return f; }
+inline unsigned int laneBits(float f) { unsigned int bits; std::memcpy(&bits, &f, 4); return bits; }
+inline Float4 operator+(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x + y; }); }
+inline Float4 operator-(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x - y; }); }
+inline Float4 operator*(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x * y; }); }
+inline Float4 operator/(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x / y; }); }
+inline Float4 operator&(Float4 a, Float4 b)
+{
+    return lanes4(a, b, [](float x, float y) { unsigned int bits = laneBits(x) & laneBits(y); float f; std::memcpy(&f, &bits, 4); return f; });
+}
+inline Float4 operator<(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x < y ? trueLane() : 0.0f; }); }
+inline Float4 operator<=(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x <= y ? trueLane() : 0.0f; }); }
+inline Float4 operator>(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x > y ? trueLane() : 0.0f; }); }
+inline Float4 min4(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x < y ? x : y; }); }
+inline Float4 max4(Float4 a, Float4 b) { return lanes4(a, b, [](float x, float y) { return x > y ? x : y; }); }
+inline Float4 abs4(Float4 a) { return lanes4(a, a, [](float x, float) { return std::fabs(x); }); }
+inline Float4 sqrt4(Float4 a) { return lanes4(a, a, [](float x, float) { return std::sqrt(x); }); }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b)
+{
+    Float4 r;
+    for (int i = 0; i < 4; i++) {
+        r.v[i] = laneBits(mask.v[i]) != 0 ? a.v[i] : b.v[i];
+    }
+    return r;
+}
+inline int mask4(Float4 m)
+{
+    int bits = 0;
+    for (int i = 0; i < 4; i++) {
+        bits |= (laneBits(m.v[i]) >> 31) << i;
+    }
+    return bits;
+}
+#endif
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// Fixed-timestep frame driver.
+// Simulation advances in constant steps of `step` seconds, rendering happens as often as the caller
+// (or the optional render rate cap) allows and interpolates between the last two simulation states.
+//
+//     loop.beginFrame();
+//     while (loop.shouldStep()) { previous = current; simulate(current, loop.step()); }
+//     render(interpolate(previous, current, loop.alpha()));
+class FrameLoop
+{
+public:
+    FrameLoop(double step = 1.0 / 60.0, int maxStepsPerFrame = 5) : fixedStep(step), maxSteps(maxStepsPerFrame)
+    {
+        start = Clock::now();
+        lastFrame = start;
+    }
+
+    // samples the clock once per rendered frame, sleeping first if a render rate cap is set
+    void beginFrame()
+    {
+        if (renderInterval > 0.0 && fixedFrameTime == 0.0) {
+            Clock::time_point next = lastFrame + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(renderInterval));
+            if (Clock::now() < next) {
+                std::this_thread::sleep_until(next);
+            }
+        }
+        Clock::time_point now = Clock::now();
+        delta = fixedFrameTime > 0.0 ? fixedFrameTime : std::chrono::duration<double>(now - lastFrame).count();
+        lastFrame = now;
+        frames++;
+
+        accumulator += delta;
+        // catch-up limit: after a long stall drop the backlog instead of spiralling into ever longer frames
+        double maxBacklog = fixedStep * maxSteps;
+        if (accumulator > maxBacklog) {
+            skipped += accumulator - maxBacklog;
+            accumulator = maxBacklog;
+        }
+    }
+
+    // true while there is a whole simulation step left to run this frame; consumes that step
+    bool shouldStep()
+    {
+        if (accumulator < fixedStep) {
+            return false;
+        }
+        accumulator -= fixedStep;
+        simTime += fixedStep;
+        steps++;
+        return true;
+    }
+
+    // call after the loop has been paused so the time spent paused isn't simulated
+    void resume()
+    {
+        lastFrame = Clock::now();
+        accumulator = 0.0;
+    }
+
+    // limits rendering to `hz` frames per second, 0 renders as fast as possible (or at vsync)
+    void setMaxRenderRate(double hz)
+    {
+        renderInterval = hz > 0.0 ? 1.0 / hz : 0.0;
+    }
+
+    // every frame advances exactly `seconds` whatever the wall clock says, 0 goes back to real time.
+    // Headless runs use this so frame N always shows the same simulation state.
+    void setFixedFrameTime(double seconds)
+    {
+        fixedFrameTime = seconds > 0.0 ? seconds : 0.0;
+    }
+
+    double getFixedFrameTime() const { return fixedFrameTime; }
+
+    // seconds per simulation step
+    double step() const { return fixedStep; }
+    // blend factor between the previous and the current simulation state, in [0, 1)
+    double alpha() const { return accumulator / fixedStep; }
+    // simulated seconds since the loop started
+    double simulationTime() const { return simTime; }
+    // wall-clock seconds since the loop started
+    double time() const { return std::chrono::duration<double>(Clock::now() - start).count(); }
+    // wall-clock seconds between the last two rendered frames
+    double frameDelta() const { return delta; }
+    unsigned long long frameCount() const { return frames; }
+    unsigned long long stepCount() const { return steps; }
+    // wall-clock seconds dropped by the catch-up limit
+    double skippedTime() const { return skipped; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point start;
+    Clock::time_point lastFrame;
+    double fixedStep;
+    int maxSteps;
+    double renderInterval = 0.0;
+    double fixedFrameTime = 0.0;
+    double accumulator = 0.0;
+    double simTime = 0.0;
+    double delta = 0.0;
+    double skipped = 0.0;
+    unsigned long long frames = 0;
+    unsigned long long steps = 0;
+};
+
+// The angle turned after `time` seconds at `radiansPerSecond`, wrapped to [0, 2 pi) before it becomes a
+// float: a float time stops resolving a 60 Hz step after a few days, the wrapped angle never does
+inline float wrappedAngle(double time, double radiansPerSecond)
+{
+    return (float)std::fmod(time * radiansPerSecond, 2.0 * glm::pi<double>());
+}
+
+// Simulation-side object state; render code interpolates two of these instead of reading the clock
+struct Transform {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+
+    glm::mat4 matrix() const
+    {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+        model = model * glm::mat4_cast(rotation);
+        return glm::scale(model, scale);
+    }
+};
+
+inline Transform interpolate(const Transform& previous, const Transform& current, double alpha)
+{
+    float t = static_cast<float>(alpha);
+    Transform result;
+    result.position = glm::mix(previous.position, current.position, t);
+    result.rotation = glm::slerp(previous.rotation, current.rotation, t);
+    result.scale = glm::mix(previous.scale, current.scale, t);
+    return result;
+}
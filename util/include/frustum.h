@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Gribb / Hartmann: each plane of the view frustum of `m` (projection * view) is a sum or difference of
+// rows of the matrix; normalized so dot(plane.xyz, p) + plane.w is a signed distance, positive inside
+inline void frustumPlanes(const glm::mat4& m, glm::vec4 planes[6])
+{
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++) {
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        planes[i * 2] = row[3] + row[i];
+        planes[i * 2 + 1] = row[3] - row[i];
+    }
+    for (int i = 0; i < 6; i++) {
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+    }
+}
+
+// a bounding sphere (center, radius) moved by `model`; it grows with the largest axis scale
+inline glm::vec4 transformSphere(const glm::mat4& model, const glm::vec4& sphere)
+{
+    float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    return glm::vec4(glm::vec3(model * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w * scale);
+}
+
+// whether any of the sphere (center, radius) may be inside the planes
+inline bool sphereInFrustum(const glm::vec4 planes[6], const glm::vec4& sphere)
+{
+    for (int i = 0; i < 6; i++) {
+        if (glm::dot(glm::vec3(planes[i]), glm::vec3(sphere)) + planes[i].w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <iostream>
+
+// Geometry buffer of deferred shading, 12 bytes a pixel:
+//     0  GL_RGBA8     albedo rgb, specular intensity (the demos' specular maps are grey)
+//     1  GL_RGB10_A2  octahedral normal in rg, log2(shininess) / 10 in b
+//     2  depth        24 bits; the lighting passes rebuild world positions from it
+// The geometry pass renders into framebuffer; the lighting passes read the three textures with
+// texelFetch, so they have no filtering or mipmaps. resize() recreates everything when the size changes.
+class GBuffer
+{
+public:
+    static const unsigned int TEXTURE_COUNT = 3;
+
+    void resize(unsigned int newWidth, unsigned int newHeight)
+    {
+        if (framebuffer != 0 && newWidth == width && newHeight == height) {
+            return;
+        }
+        destroy();
+        width = newWidth;
+        height = newHeight;
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        textures[0] = createTexture(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+        textures[1] = createTexture(GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV);
+        textures[2] = createTexture(GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[0], 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, textures[1], 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, textures[2], 0);
+        GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        glDrawBuffers(2, attachments);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::GBUFFER:: Framebuffer is not complete" << std::endl;
+        }
+    }
+
+    // the textures on units firstUnit, firstUnit + 1, firstUnit + 2
+    void bindTextures(unsigned int firstUnit) const
+    {
+        for (unsigned int i = 0; i < TEXTURE_COUNT; i++) {
+            glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+            glBindTexture(GL_TEXTURE_2D, textures[i]);
+        }
+    }
+
+    // bytes of GPU memory per pixel, depth included
+    static unsigned int bytesPerPixel() { return 4 + 4 + 4; }
+
+    void destroy()
+    {
+        if (framebuffer == 0) {
+            return;
+        }
+        glDeleteTextures(TEXTURE_COUNT, textures);
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+        width = height = 0;
+    }
+
+    unsigned int framebuffer = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+private:
+    unsigned int createTexture(GLenum internalFormat, GLenum format, GLenum type) const
+    {
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+
+    unsigned int textures[TEXTURE_COUNT] = { 0, 0, 0 };
+};
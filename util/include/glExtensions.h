@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+// Entry points newer than the bundled glad (GL 4.3 core). loadGLExtensions() is called by Application
+// right after glad; a pointer stays NULL when the driver doesn't have the feature.
+
+// GL 4.4 / GL_ARB_buffer_storage
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+struct GLExtensions {
+    PFNGLBUFFERSTORAGEPROC bufferStorage = NULL;
+};
+
+inline GLExtensions& glExtensions()
+{
+    static GLExtensions extensions;
+    return extensions;
+}
+
+inline bool hasGLExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (extension != NULL && std::strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void loadGLExtensions(GLADloadproc load)
+{
+    GLExtensions& extensions = glExtensions();
+    // the loader may hand out a stub for anything, so check the extension list first
+    bool version44 = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 4);
+    if (version44 || hasGLExtension("GL_ARB_buffer_storage")) {
+        extensions.bufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+    }
+}
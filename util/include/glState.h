@@ -0,0 +1,487 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// What the state cache tracks, for its per-frame counters
+enum GLStateKind {
+    STATE_PROGRAM,
+    STATE_VERTEX_ARRAY,
+    STATE_BUFFER,
+    STATE_TEXTURE,
+    // enable / disable, depth and blend functions
+    STATE_RENDER,
+    STATE_VIEWPORT,
+    STATE_KINDS
+};
+
+struct GLStateCounts {
+    unsigned int calls[STATE_KINDS] = {};
+    unsigned int skipped[STATE_KINDS] = {};
+
+    unsigned int totalCalls() const
+    {
+        unsigned int total = 0;
+        for (int i = 0; i < STATE_KINDS; i++) {
+            total += calls[i];
+        }
+        return total;
+    }
+
+    unsigned int totalSkipped() const
+    {
+        unsigned int total = 0;
+        for (int i = 0; i < STATE_KINDS; i++) {
+            total += skipped[i];
+        }
+        return total;
+    }
+};
+
+// Drops GL calls that would set state to what it already is. install() swaps glad's function pointers
+// for program, VAO, buffer and texture binds, enable / disable, depth and blend state and the viewport
+// with wrappers that remember the last value and only forward changes, so every caller (demo code,
+// Shader::use, the util helpers) goes through the cache without being rewritten.
+//
+// Anything not known yet - right after install(), a deleted object's bindings, the element buffer after
+// a VAO switch - is forwarded and remembered. Application installs it after loading GL and calls
+// endFrame() after every frame; lastFrame() has the counts of the frame before.
+class GLState
+{
+public:
+    static const unsigned int MAX_TEXTURE_UNITS = 32;
+    static const unsigned int MAX_BUFFER_INDICES = 16;
+
+    void install()
+    {
+        if (glad_glUseProgram != &hookUseProgram) {
+            useProgram = glad_glUseProgram;
+            bindVertexArray = glad_glBindVertexArray;
+            deleteVertexArrays = glad_glDeleteVertexArrays;
+            bindBuffer = glad_glBindBuffer;
+            bindBufferBase = glad_glBindBufferBase;
+            bindBufferRange = glad_glBindBufferRange;
+            deleteBuffers = glad_glDeleteBuffers;
+            activeTexture = glad_glActiveTexture;
+            bindTexture = glad_glBindTexture;
+            deleteTextures = glad_glDeleteTextures;
+            enable = glad_glEnable;
+            disable = glad_glDisable;
+            depthFunc = glad_glDepthFunc;
+            depthMask = glad_glDepthMask;
+            blendFunc = glad_glBlendFunc;
+            blendFuncSeparate = glad_glBlendFuncSeparate;
+            viewport = glad_glViewport;
+        }
+        glad_glUseProgram = &hookUseProgram;
+        glad_glBindVertexArray = &hookBindVertexArray;
+        glad_glDeleteVertexArrays = &hookDeleteVertexArrays;
+        glad_glBindBuffer = &hookBindBuffer;
+        glad_glBindBufferBase = &hookBindBufferBase;
+        glad_glBindBufferRange = &hookBindBufferRange;
+        glad_glDeleteBuffers = &hookDeleteBuffers;
+        glad_glActiveTexture = &hookActiveTexture;
+        glad_glBindTexture = &hookBindTexture;
+        glad_glDeleteTextures = &hookDeleteTextures;
+        glad_glEnable = &hookEnable;
+        glad_glDisable = &hookDisable;
+        glad_glDepthFunc = &hookDepthFunc;
+        glad_glDepthMask = &hookDepthMask;
+        glad_glBlendFunc = &hookBlendFunc;
+        glad_glBlendFuncSeparate = &hookBlendFuncSeparate;
+        glad_glViewport = &hookViewport;
+        invalidate();
+    }
+
+    // forget everything, e.g. after GL calls the cache couldn't see
+    void invalidate()
+    {
+        program = vertexArray = UNKNOWN;
+        for (int i = 0; i < BUFFER_TARGETS; i++) {
+            buffers[i] = UNKNOWN;
+        }
+        for (int i = 0; i < INDEXED_TARGETS; i++) {
+            for (unsigned int j = 0; j < MAX_BUFFER_INDICES; j++) {
+                indexed[i][j].buffer = UNKNOWN;
+            }
+        }
+        unit = UNKNOWN;
+        for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++) {
+            for (int j = 0; j < TEXTURE_TARGETS; j++) {
+                textures[i][j] = UNKNOWN;
+            }
+        }
+        for (int i = 0; i < CAPABILITIES; i++) {
+            enabled[i] = UNKNOWN;
+        }
+        depthFunction = depthWrite = UNKNOWN;
+        for (int i = 0; i < 4; i++) {
+            blend[i] = UNKNOWN;
+        }
+        viewportKnown = false;
+    }
+
+    void endFrame()
+    {
+        last = current;
+        current = GLStateCounts();
+    }
+
+    const GLStateCounts& lastFrame() const { return last; }
+
+private:
+    static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+    enum { BUFFER_TARGETS = 8, INDEXED_TARGETS = 2, TEXTURE_TARGETS = 4, CAPABILITIES = 8 };
+
+    struct IndexedBinding {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+
+    static int bufferTarget(GLenum target)
+    {
+        switch (target) {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_ELEMENT_ARRAY_BUFFER: return 1;
+        case GL_UNIFORM_BUFFER: return 2;
+        case GL_SHADER_STORAGE_BUFFER: return 3;
+        case GL_DRAW_INDIRECT_BUFFER: return 4;
+        case GL_DISPATCH_INDIRECT_BUFFER: return 5;
+        case GL_COPY_READ_BUFFER: return 6;
+        case GL_COPY_WRITE_BUFFER: return 7;
+        default: return -1;
+        }
+    }
+
+    static int indexedTarget(GLenum target)
+    {
+        switch (target) {
+        case GL_UNIFORM_BUFFER: return 0;
+        case GL_SHADER_STORAGE_BUFFER: return 1;
+        default: return -1;
+        }
+    }
+
+    static int textureTarget(GLenum target)
+    {
+        switch (target) {
+        case GL_TEXTURE_2D: return 0;
+        case GL_TEXTURE_CUBE_MAP: return 1;
+        case GL_TEXTURE_2D_ARRAY: return 2;
+        case GL_TEXTURE_3D: return 3;
+        default: return -1;
+        }
+    }
+
+    static int capability(GLenum cap)
+    {
+        switch (cap) {
+        case GL_DEPTH_TEST: return 0;
+        case GL_BLEND: return 1;
+        case GL_CULL_FACE: return 2;
+        case GL_STENCIL_TEST: return 3;
+        case GL_SCISSOR_TEST: return 4;
+        case GL_POLYGON_OFFSET_FILL: return 5;
+        case GL_FRAMEBUFFER_SRGB: return 6;
+        case GL_PROGRAM_POINT_SIZE: return 7;
+        default: return -1;
+        }
+    }
+
+    // counts the call; true when it changes nothing and can be dropped
+    bool same(GLStateKind kind, bool unchanged)
+    {
+        current.calls[kind]++;
+        if (unchanged) {
+            current.skipped[kind]++;
+        }
+        return unchanged;
+    }
+
+    // a deleted name may come back from glGen*, so nothing bound to it is known any more
+    static void forget(GLuint* values, int count, const GLuint* names, GLsizei n)
+    {
+        for (int i = 0; i < count; i++) {
+            for (GLsizei j = 0; j < n; j++) {
+                if (values[i] == names[j]) {
+                    values[i] = UNKNOWN;
+                }
+            }
+        }
+    }
+
+    static void APIENTRY hookUseProgram(GLuint program);
+    static void APIENTRY hookBindVertexArray(GLuint array);
+    static void APIENTRY hookDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+    static void APIENTRY hookBindBuffer(GLenum target, GLuint buffer);
+    static void APIENTRY hookBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    static void APIENTRY hookBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    static void APIENTRY hookDeleteBuffers(GLsizei n, const GLuint* buffers);
+    static void APIENTRY hookActiveTexture(GLenum texture);
+    static void APIENTRY hookBindTexture(GLenum target, GLuint texture);
+    static void APIENTRY hookDeleteTextures(GLsizei n, const GLuint* textures);
+    static void APIENTRY hookEnable(GLenum cap);
+    static void APIENTRY hookDisable(GLenum cap);
+    static void APIENTRY hookDepthFunc(GLenum func);
+    static void APIENTRY hookDepthMask(GLboolean flag);
+    static void APIENTRY hookBlendFunc(GLenum sfactor, GLenum dfactor);
+    static void APIENTRY hookBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+    static void APIENTRY hookViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // glad's entry points, called for anything that changes state
+    PFNGLUSEPROGRAMPROC useProgram = NULL;
+    PFNGLBINDVERTEXARRAYPROC bindVertexArray = NULL;
+    PFNGLDELETEVERTEXARRAYSPROC deleteVertexArrays = NULL;
+    PFNGLBINDBUFFERPROC bindBuffer = NULL;
+    PFNGLBINDBUFFERBASEPROC bindBufferBase = NULL;
+    PFNGLBINDBUFFERRANGEPROC bindBufferRange = NULL;
+    PFNGLDELETEBUFFERSPROC deleteBuffers = NULL;
+    PFNGLACTIVETEXTUREPROC activeTexture = NULL;
+    PFNGLBINDTEXTUREPROC bindTexture = NULL;
+    PFNGLDELETETEXTURESPROC deleteTextures = NULL;
+    PFNGLENABLEPROC enable = NULL;
+    PFNGLDISABLEPROC disable = NULL;
+    PFNGLDEPTHFUNCPROC depthFunc = NULL;
+    PFNGLDEPTHMASKPROC depthMask = NULL;
+    PFNGLBLENDFUNCPROC blendFunc = NULL;
+    PFNGLBLENDFUNCSEPARATEPROC blendFuncSeparate = NULL;
+    PFNGLVIEWPORTPROC viewport = NULL;
+
+    GLuint program = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+    GLuint buffers[BUFFER_TARGETS];
+    IndexedBinding indexed[INDEXED_TARGETS][MAX_BUFFER_INDICES];
+    // GL_TEXTURE0 + n
+    GLuint unit = UNKNOWN;
+    GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+    GLuint enabled[CAPABILITIES];
+    GLuint depthFunction = UNKNOWN;
+    GLuint depthWrite = UNKNOWN;
+    GLuint blend[4];
+    GLint viewportRect[4] = {};
+    bool viewportKnown = false;
+    GLStateCounts current;
+    GLStateCounts last;
+};
+
+// the state of the (one) current context
+inline GLState& glState()
+{
+    static GLState state;
+    return state;
+}
+
+inline void APIENTRY GLState::hookUseProgram(GLuint program)
+{
+    GLState& s = glState();
+    if (s.same(STATE_PROGRAM, s.program == program)) {
+        return;
+    }
+    s.useProgram(program);
+    s.program = program;
+}
+
+inline void APIENTRY GLState::hookBindVertexArray(GLuint array)
+{
+    GLState& s = glState();
+    if (s.same(STATE_VERTEX_ARRAY, s.vertexArray == array)) {
+        return;
+    }
+    s.bindVertexArray(array);
+    s.vertexArray = array;
+    // the element buffer binding is part of the VAO
+    s.buffers[bufferTarget(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+}
+
+inline void APIENTRY GLState::hookDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    GLState& s = glState();
+    s.deleteVertexArrays(n, arrays);
+    forget(&s.vertexArray, 1, arrays, n);
+    s.buffers[bufferTarget(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+}
+
+inline void APIENTRY GLState::hookBindBuffer(GLenum target, GLuint buffer)
+{
+    GLState& s = glState();
+    int t = bufferTarget(target);
+    if (s.same(STATE_BUFFER, t >= 0 && s.buffers[t] == buffer)) {
+        return;
+    }
+    s.bindBuffer(target, buffer);
+    if (t >= 0) {
+        s.buffers[t] = buffer;
+    }
+}
+
+inline void APIENTRY GLState::hookBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    GLState& s = glState();
+    int t = indexedTarget(target);
+    bool tracked = t >= 0 && index < MAX_BUFFER_INDICES;
+    if (s.same(STATE_BUFFER, tracked && s.indexed[t][index].buffer == buffer && s.indexed[t][index].size == -1)) {
+        return;
+    }
+    s.bindBufferBase(target, index, buffer);
+    if (tracked) {
+        s.indexed[t][index].buffer = buffer;
+        s.indexed[t][index].offset = 0;
+        s.indexed[t][index].size = -1;
+    }
+    // binding an index also binds the generic target
+    t = bufferTarget(target);
+    if (t >= 0) {
+        s.buffers[t] = buffer;
+    }
+}
+
+inline void APIENTRY GLState::hookBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    GLState& s = glState();
+    int t = indexedTarget(target);
+    bool tracked = t >= 0 && index < MAX_BUFFER_INDICES;
+    if (s.same(STATE_BUFFER, tracked && s.indexed[t][index].buffer == buffer && s.indexed[t][index].offset == offset
+        && s.indexed[t][index].size == size)) {
+        return;
+    }
+    s.bindBufferRange(target, index, buffer, offset, size);
+    if (tracked) {
+        s.indexed[t][index].buffer = buffer;
+        s.indexed[t][index].offset = offset;
+        s.indexed[t][index].size = size;
+    }
+    t = bufferTarget(target);
+    if (t >= 0) {
+        s.buffers[t] = buffer;
+    }
+}
+
+inline void APIENTRY GLState::hookDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    GLState& s = glState();
+    s.deleteBuffers(n, buffers);
+    forget(s.buffers, BUFFER_TARGETS, buffers, n);
+    for (int i = 0; i < INDEXED_TARGETS; i++) {
+        for (unsigned int j = 0; j < MAX_BUFFER_INDICES; j++) {
+            forget(&s.indexed[i][j].buffer, 1, buffers, n);
+        }
+    }
+}
+
+inline void APIENTRY GLState::hookActiveTexture(GLenum texture)
+{
+    GLState& s = glState();
+    if (s.same(STATE_TEXTURE, s.unit == texture)) {
+        return;
+    }
+    s.activeTexture(texture);
+    s.unit = texture;
+}
+
+inline void APIENTRY GLState::hookBindTexture(GLenum target, GLuint texture)
+{
+    GLState& s = glState();
+    int t = textureTarget(target);
+    GLuint unit = s.unit - GL_TEXTURE0;
+    bool tracked = t >= 0 && s.unit != UNKNOWN && unit < MAX_TEXTURE_UNITS;
+    if (s.same(STATE_TEXTURE, tracked && s.textures[unit][t] == texture)) {
+        return;
+    }
+    s.bindTexture(target, texture);
+    if (tracked) {
+        s.textures[unit][t] = texture;
+    }
+}
+
+inline void APIENTRY GLState::hookDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    GLState& s = glState();
+    s.deleteTextures(n, textures);
+    forget(&s.textures[0][0], MAX_TEXTURE_UNITS * TEXTURE_TARGETS, textures, n);
+}
+
+inline void APIENTRY GLState::hookEnable(GLenum cap)
+{
+    GLState& s = glState();
+    int c = capability(cap);
+    if (s.same(STATE_RENDER, c >= 0 && s.enabled[c] == 1)) {
+        return;
+    }
+    s.enable(cap);
+    if (c >= 0) {
+        s.enabled[c] = 1;
+    }
+}
+
+inline void APIENTRY GLState::hookDisable(GLenum cap)
+{
+    GLState& s = glState();
+    int c = capability(cap);
+    if (s.same(STATE_RENDER, c >= 0 && s.enabled[c] == 0)) {
+        return;
+    }
+    s.disable(cap);
+    if (c >= 0) {
+        s.enabled[c] = 0;
+    }
+}
+
+inline void APIENTRY GLState::hookDepthFunc(GLenum func)
+{
+    GLState& s = glState();
+    if (s.same(STATE_RENDER, s.depthFunction == func)) {
+        return;
+    }
+    s.depthFunc(func);
+    s.depthFunction = func;
+}
+
+inline void APIENTRY GLState::hookDepthMask(GLboolean flag)
+{
+    GLState& s = glState();
+    if (s.same(STATE_RENDER, s.depthWrite == (GLuint)flag)) {
+        return;
+    }
+    s.depthMask(flag);
+    s.depthWrite = flag;
+}
+
+inline void APIENTRY GLState::hookBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    GLState& s = glState();
+    if (s.same(STATE_RENDER, s.blend[0] == sfactor && s.blend[1] == dfactor && s.blend[2] == sfactor && s.blend[3] == dfactor)) {
+        return;
+    }
+    s.blendFunc(sfactor, dfactor);
+    s.blend[0] = s.blend[2] = sfactor;
+    s.blend[1] = s.blend[3] = dfactor;
+}
+
+inline void APIENTRY GLState::hookBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    GLState& s = glState();
+    if (s.same(STATE_RENDER, s.blend[0] == srcRGB && s.blend[1] == dstRGB && s.blend[2] == srcAlpha && s.blend[3] == dstAlpha)) {
+        return;
+    }
+    s.blendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    s.blend[0] = srcRGB;
+    s.blend[1] = dstRGB;
+    s.blend[2] = srcAlpha;
+    s.blend[3] = dstAlpha;
+}
+
+inline void APIENTRY GLState::hookViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    GLState& s = glState();
+    if (s.same(STATE_VIEWPORT, s.viewportKnown && s.viewportRect[0] == x && s.viewportRect[1] == y
+        && s.viewportRect[2] == width && s.viewportRect[3] == height)) {
+        return;
+    }
+    s.viewport(x, y, width, height);
+    s.viewportRect[0] = x;
+    s.viewportRect[1] = y;
+    s.viewportRect[2] = width;
+    s.viewportRect[3] = height;
+    s.viewportKnown = true;
+}
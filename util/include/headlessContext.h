@@ -0,0 +1,176 @@
+#pragma once
+
+// Offscreen OpenGL 4.3 core context for machines without a display (build / benchmark hosts).
+// Only compiled when LEARNOPENGL_HEADLESS is defined; link with -lEGL, or define LEARNOPENGL_OSMESA
+// as well and link with -lOSMesa. Both work with Mesa's software llvmpipe driver
+// (LIBGL_ALWAYS_SOFTWARE=1 forces it on a machine that does have a GPU).
+//
+// Rendering goes to a framebuffer object rather than a window surface, so the demos don't need to
+// know which backend is in use; glad must be included before this header.
+
+#include <glad/glad.h>
+
+#if defined(LEARNOPENGL_OSMESA)
+#include <GL/osmesa.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+class HeadlessContext
+{
+public:
+    ~HeadlessContext()
+    {
+        destroy();
+    }
+
+    // creates the context and makes it current; load glad with getProcAddress afterwards
+    bool create(unsigned int width, unsigned int height)
+    {
+#if defined(LEARNOPENGL_OSMESA)
+        const int attribs[] = {
+            OSMESA_FORMAT, OSMESA_RGBA,
+            OSMESA_DEPTH_BITS, 24,
+            OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+            OSMESA_CONTEXT_MAJOR_VERSION, 4,
+            OSMESA_CONTEXT_MINOR_VERSION, 3,
+            0
+        };
+        context = OSMesaCreateContextAttribs(attribs, NULL);
+        if (context == NULL) {
+            std::cout << "Failed to create OSMesa context" << std::endl;
+            return false;
+        }
+        // OSMesa needs a colour buffer to make the context current even though we render to an FBO
+        buffer.resize(width * height * 4);
+        return OSMesaMakeCurrent(context, buffer.data(), GL_UNSIGNED_BYTE, width, height);
+#else
+        // prefer the surfaceless platform: it needs neither X11/Wayland nor a DRM device
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay != NULL) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        }
+        if (display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+            std::cout << "Failed to initialize EGL display" << std::endl;
+            return false;
+        }
+
+        // the default surface type is EGL_WINDOW_BIT, which the surfaceless platform never offers
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+            std::cout << "Failed to find an EGL config with desktop OpenGL support" << std::endl;
+            return false;
+        }
+
+        eglBindAPI(EGL_OPENGL_API);
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION_KHR, 4,
+            EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (context == EGL_NO_CONTEXT) {
+            std::cout << "Failed to create EGL OpenGL 4.3 core context" << std::endl;
+            return false;
+        }
+        // EGL_KHR_surfaceless_context: current without any surface, all drawing goes to our FBO
+        return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+#endif
+    }
+
+    // colour + depth/stencil render target that stands in for the window's back buffer; stays bound
+    void createFramebuffer(unsigned int width, unsigned int height)
+    {
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+        glGenRenderbuffers(2, renderbuffers);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::FRAMEBUFFER:: Headless framebuffer is not complete!" << std::endl;
+        }
+        glViewport(0, 0, width, height);
+    }
+
+    void destroy()
+    {
+#if defined(LEARNOPENGL_OSMESA)
+        if (context != NULL) {
+            OSMesaDestroyContext(context);
+            context = NULL;
+        }
+#else
+        if (display != EGL_NO_DISPLAY) {
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context != EGL_NO_CONTEXT) {
+                eglDestroyContext(display, context);
+                context = EGL_NO_CONTEXT;
+            }
+            eglTerminate(display);
+            display = EGL_NO_DISPLAY;
+        }
+#endif
+    }
+
+    // loader for gladLoadGLLoader
+    static void* getProcAddress(const char* name)
+    {
+#if defined(LEARNOPENGL_OSMESA)
+        return (void*)OSMesaGetProcAddress(name);
+#else
+        return (void*)eglGetProcAddress(name);
+#endif
+    }
+
+    // writes the bound framebuffer's colour buffer as a binary PPM, top row first, for image checks
+    static bool writeImage(const char* path, unsigned int width, unsigned int height)
+    {
+        std::vector<unsigned char> pixels(width * height * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            std::cout << "ERROR::HEADLESS::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+        file << "P6\n" << width << " " << height << "\n255\n";
+        // GL rows start at the bottom
+        for (unsigned int y = height; y > 0; y--) {
+            file.write((const char*)&pixels[(y - 1) * width * 3], width * 3);
+        }
+        return true;
+    }
+
+private:
+#if defined(LEARNOPENGL_OSMESA)
+    OSMesaContext context = NULL;
+    std::vector<unsigned char> buffer;
+#else
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+#endif
+    unsigned int framebuffer = 0;
+    unsigned int renderbuffers[2] = {};
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <frustum.h>
+#include <instancedRenderer.h>
+#include <shader.h>
+#include <spinAnimation.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// glMultiDrawElementsIndirect record, layout fixed by GL
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// GPU-driven variant of InstancedRenderer. Instances stay in GPU buffers; every frame a compute shader
+// tests each instance's bounding sphere against the view frustum, appends the visible ones to their
+// draw's range of an output instance buffer and bumps that draw's instanceCount, and one
+// glMultiDrawElementsIndirect submits every draw. The CPU cost of a frame is one dispatch plus
+// rewriting the (per draw, not per instance) command buffer, however many instances there are.
+//
+//     unsigned int draw = renderer.addDraw(cube.indexCount(), cube.firstIndex(), 0, boundingSphere(cubeMesh()));
+//     renderer.attach(VAO);                              // once, after the mesh attributes are set up
+//     renderer.clear();                                  // whenever the instances change, not per frame
+//     for (...) renderer.add(model, draw);
+//     renderer.cull(projection * view);                  // every frame, before the draw shader is bound
+//     renderer.draw(VAO, GL_TRIANGLES, cube.indexType());
+//
+// The vertex shader reads the same instance attributes as with InstancedRenderer. Instances that only
+// turn about a fixed axis stay static too: add() takes their spin, which reaches the vertex shader at
+// SPIN_LOCATION as with SpinAnimation, and the cull tests the sphere covering every turn.
+class IndirectRenderer
+{
+public:
+    // one draw per mesh sharing the VAO's element buffer; `sphere` is the mesh's local bounds (center, radius)
+    unsigned int addDraw(GLuint count, GLuint firstIndex, GLint baseVertex, const glm::vec4& sphere)
+    {
+        DrawElementsIndirectCommand command = { count, 0, firstIndex, baseVertex, 0 };
+        commands.push_back(command);
+        bounds.push_back(sphere);
+        drawInstances.push_back(0);
+        dirty = true;
+        return (unsigned int)commands.size() - 1;
+    }
+
+    // after the mesh behind `draw` has moved in its element buffer (see MeshBuffer::refresh); the
+    // commands are uploaded by every cull(), so the next one picks it up
+    void setFirstIndex(unsigned int draw, GLuint firstIndex)
+    {
+        commands[draw].firstIndex = firstIndex;
+    }
+
+    // the instance attributes of `vao` read the culled instances
+    void attach(unsigned int vao)
+    {
+        createBuffers();
+        InstancedRenderer::attachInstanceBuffer(vao, visibleBuffer);
+        glBindVertexArray(vao);
+        glVertexAttribFormat(SPIN_LOCATION, 4, GL_FLOAT, GL_FALSE, 0);
+        glVertexAttribBinding(SPIN_LOCATION, SPIN_LOCATION);
+        glEnableVertexAttribArray(SPIN_LOCATION);
+        glVertexBindingDivisor(SPIN_LOCATION, 1);
+        glBindVertexBuffer(SPIN_LOCATION, visibleSpinBuffer, 0, sizeof(glm::vec4));
+        glBindVertexArray(0);
+    }
+
+    void clear()
+    {
+        instances.clear();
+        spins.clear();
+        drawIds.clear();
+        std::fill(drawInstances.begin(), drawInstances.end(), 0);
+        dirty = true;
+    }
+
+    // `spin` is a unit axis in xyz and radians per second in w, turned before `model` in the vertex
+    // shader (see SpinAnimation); a zero w doesn't turn
+    void add(const glm::mat4& model, unsigned int draw, unsigned int material = 0, const glm::vec4& spin = glm::vec4(0.0f))
+    {
+        instances.push_back(InstancedRenderer::makeInstance(model, material));
+        spins.push_back(spin);
+        drawIds.push_back(draw);
+        drawInstances[draw]++;
+        dirty = true;
+    }
+
+    // decides on the GPU which instances are inside the frustum of `viewProjection`; binds its own program
+    void cull(const glm::mat4& viewProjection)
+    {
+        upload();
+
+        // the draws' instanceCounts start at zero every frame, the cull shader counts them back up
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+        if (instances.empty()) {
+            return;
+        }
+
+        glm::vec4 planes[6];
+        frustumPlanes(viewProjection, planes);
+        glUseProgram(cullProgram);
+        glUniform1ui(instanceCountLocation, (GLuint)instances.size());
+        glUniform4fv(planesLocation, 6, &planes[0].x);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, drawIdBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, boundsBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, visibleBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, spinBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, visibleSpinBuffer);
+        glDispatchCompute((GLuint)((instances.size() + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE), 1, 1);
+        // the draw reads the commands and the culled instances the dispatch wrote
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+
+    // every draw at once, with the instances the last cull() kept; or `drawCount` draws from
+    // `firstDraw`, for meshes that need a VAO or program of their own
+    void draw(unsigned int vao, GLenum mode, GLenum indexType, unsigned int firstDraw = 0, unsigned int drawCount = ~0u)
+    {
+        drawCount = std::min(drawCount, (unsigned int)commands.size() - std::min(firstDraw, (unsigned int)commands.size()));
+        if (drawCount == 0) {
+            return;
+        }
+        glBindVertexArray(vao);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glMultiDrawElementsIndirect(mode, indexType, (void*)(firstDraw * sizeof(DrawElementsIndirectCommand)), (GLsizei)drawCount, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    size_t size() const { return instances.size(); }
+    size_t drawCount() const { return commands.size(); }
+
+    void destroy()
+    {
+        unsigned int buffers[] = { instanceBuffer, drawIdBuffer, boundsBuffer, commandBuffer, visibleBuffer, spinBuffer, visibleSpinBuffer };
+        glDeleteBuffers(7, buffers);
+        instanceBuffer = drawIdBuffer = boundsBuffer = commandBuffer = visibleBuffer = spinBuffer = visibleSpinBuffer = 0;
+        glDeleteProgram(cullProgram);
+        cullProgram = 0;
+        capacity = 0;
+    }
+
+private:
+    static const unsigned int WORKGROUP_SIZE = 256;
+
+    void createBuffers()
+    {
+        if (cullProgram != 0) {
+            return;
+        }
+        glGenBuffers(1, &instanceBuffer);
+        glGenBuffers(1, &drawIdBuffer);
+        glGenBuffers(1, &boundsBuffer);
+        glGenBuffers(1, &commandBuffer);
+        glGenBuffers(1, &visibleBuffer);
+        glGenBuffers(1, &spinBuffer);
+        glGenBuffers(1, &visibleSpinBuffer);
+        cullProgram = compileCullProgram();
+        instanceCountLocation = glGetUniformLocation(cullProgram, "instanceCount");
+        planesLocation = glGetUniformLocation(cullProgram, "planes");
+    }
+
+    // instances, their draw ids and the draws' first instance only change with clear() / add()
+    void upload()
+    {
+        createBuffers();
+        if (!dirty) {
+            return;
+        }
+        // every draw owns a contiguous range of the output buffer, as large as all its instances
+        GLuint first = 0;
+        for (size_t i = 0; i < commands.size(); i++) {
+            commands[i].baseInstance = first;
+            first += drawInstances[i];
+        }
+
+        size_t bytes = instances.size() * sizeof(InstanceData);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bytes, instances.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, spinBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, spins.size() * sizeof(glm::vec4), spins.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawIdBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, drawIds.size() * sizeof(unsigned int), drawIds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, boundsBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, bounds.size() * sizeof(glm::vec4), bounds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), NULL, GL_DYNAMIC_DRAW);
+        if (instances.size() > capacity) {
+            capacity = instances.size();
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(InstanceData), NULL, GL_DYNAMIC_COPY);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleSpinBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_DYNAMIC_COPY);
+        }
+        dirty = false;
+    }
+
+    static unsigned int compileCullProgram()
+    {
+        // InstanceData is copied as raw words, its std430 view (mat3 columns padded to vec4) wouldn't match
+        std::string source = std::string("#version 430 core\n")
+            + "const uint INSTANCE_WORDS = " + std::to_string(sizeof(InstanceData) / 4) + "u;\n"
+            + "layout (local_size_x = " + std::to_string(WORKGROUP_SIZE) + ") in;\n" + R"(
+struct Command {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+layout (std430, binding = 0) readonly buffer Instances { uint instances[]; };
+layout (std430, binding = 1) readonly buffer DrawIds { uint drawIds[]; };
+layout (std430, binding = 2) readonly buffer Bounds { vec4 bounds[]; };
+layout (std430, binding = 3) buffer Commands { Command commands[]; };
+layout (std430, binding = 4) writeonly buffer Visible { uint visible[]; };
+layout (std430, binding = 5) readonly buffer Spins { vec4 spins[]; };
+layout (std430, binding = 6) writeonly buffer VisibleSpins { vec4 visibleSpins[]; };
+
+uniform uint instanceCount;
+uniform vec4 planes[6];
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= instanceCount) {
+        return;
+    }
+    uint first = i * INSTANCE_WORDS;
+    mat4 model;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            model[c][r] = uintBitsToFloat(instances[first + c * 4 + r]);
+        }
+    }
+
+    // the sphere grows with the largest axis scale of the model matrix
+    uint draw = drawIds[i];
+    vec4 sphere = bounds[draw];
+    if (spins[i].w != 0.0) {
+        // the turn about the local origin sweeps the sphere around this one
+        sphere = vec4(0.0, 0.0, 0.0, length(sphere.xyz) + sphere.w);
+    }
+    vec3 center = vec3(model * vec4(sphere.xyz, 1.0));
+    float scale = max(max(dot(model[0].xyz, model[0].xyz), dot(model[1].xyz, model[1].xyz)), dot(model[2].xyz, model[2].xyz));
+    float radius = sphere.w * sqrt(scale);
+    for (int p = 0; p < 6; p++) {
+        if (dot(planes[p].xyz, center) + planes[p].w < -radius) {
+            return;
+        }
+    }
+
+    uint slot = commands[draw].baseInstance + atomicAdd(commands[draw].instanceCount, 1u);
+    for (uint w = 0u; w < INSTANCE_WORDS; w++) {
+        visible[slot * INSTANCE_WORDS + w] = instances[first + w];
+    }
+    visibleSpins[slot] = spins[i];
+}
+)";
+        return compileComputeProgram(source);
+    }
+
+    std::vector<InstanceData> instances;
+    std::vector<glm::vec4> spins;
+    std::vector<unsigned int> drawIds;
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<glm::vec4> bounds;
+    std::vector<GLuint> drawInstances;
+    unsigned int instanceBuffer = 0;
+    unsigned int drawIdBuffer = 0;
+    unsigned int boundsBuffer = 0;
+    unsigned int commandBuffer = 0;
+    unsigned int visibleBuffer = 0;
+    unsigned int spinBuffer = 0;
+    unsigned int visibleSpinBuffer = 0;
+    unsigned int cullProgram = 0;
+    int instanceCountLocation = -1;
+    int planesLocation = -1;
+    // instances the visible buffers hold
+    size_t capacity = 0;
+    bool dirty = true;
+};
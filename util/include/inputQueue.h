@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single-producer/single-consumer ring buffer.
+// Exactly one thread may call push() and exactly one (possibly different) thread may call pop().
+// Capacity must be a power of two; head and tail only ever grow and are masked on access.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    // producer side: returns false (and drops the item) when the ring is full, or when fewer than
+    // `reserve` slots would be left after it, which keeps room for items pushed without a reserve
+    bool push(const T& item, size_t reserve = 0)
+    {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) + reserve >= Capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[tail & (Capacity - 1)] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side: returns false when there is nothing to read
+    bool pop(T& item)
+    {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[head & (Capacity - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // number of items the producer could not push because the consumer fell behind
+    size_t droppedCount() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    // keep the indices on separate cache lines so producer and consumer don't false-share
+    alignas(64) std::atomic<size_t> headIndex{ 0 };
+    alignas(64) std::atomic<size_t> tailIndex{ 0 };
+    alignas(64) std::atomic<size_t> dropped{ 0 };
+    T items[Capacity];
+};
+
+enum InputEventType {
+    INPUT_KEY,
+    INPUT_CURSOR,
+    INPUT_SCROLL
+};
+
+// A window-system event captured inside a GLFW callback, to be applied later on the render thread
+struct InputEvent {
+    InputEventType type;
+    int key;      // INPUT_KEY: GLFW key code
+    int action;   // INPUT_KEY: GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    double x;     // INPUT_CURSOR: cursor x, INPUT_SCROLL: x offset
+    double y;     // INPUT_CURSOR: cursor y, INPUT_SCROLL: y offset
+};
+
+// Producer is whichever thread calls glfwPollEvents / glfwWaitEvents (GLFW requires the main thread),
+// consumer is the thread that owns the GL context and renders: the same one, or with
+// Application::run(true) a render thread of its own.
+typedef SpscRing<InputEvent, 1024> InputQueue;
+
+// Slots cursor and scroll events leave free for key events. A long frame (a bake in init(), a frame
+// of thousands of lights) lets mouse movement fill the queue; losing some of it only drops camera
+// motion, but a lost GLFW_RELEASE would leave the key held.
+const size_t INPUT_KEY_RESERVE = 256;
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <ringBuffer.h>
+
+#include <cstddef>
+#include <vector>
+
+// One drawn copy of a mesh. Instanced vertex shaders read these at fixed attribute locations,
+// after the mesh's own attributes at 0..2:
+//   layout (location = 3) in mat4 aModel;          // locations 3..6
+//   layout (location = 7) in mat3 aNormalMatrix;   // locations 7..9
+//   layout (location = 10) in uint aMaterial;
+struct InstanceData {
+    glm::mat4 model;
+    glm::mat3 normalMatrix;
+    unsigned int material;
+};
+
+// Collects per-instance transforms (and material ids) for a frame and draws every instance of a
+// mesh with one glDraw*Instanced call instead of a uniform update and a draw call per object.
+//
+//     instances.attach(VAO, frameData);                  // once, after the mesh attributes are set up
+//     instances.clear();                                 // every frame
+//     for (...) instances.add(model);
+//     instances.drawArrays(VAO, GL_TRIANGLES, 0, 36);
+//
+// Given a RingBuffer (Application::frameData) the instances are written straight into its persistently
+// mapped memory; otherwise they go through an orphaned buffer of our own.
+class InstancedRenderer
+{
+public:
+    static const unsigned int FIRST_LOCATION = 3;
+    // vertex buffer binding point all the instance attributes read from
+    static const unsigned int BINDING = FIRST_LOCATION;
+
+    // adds the per-instance attributes to `vao`; several VAOs may share one renderer
+    void attach(unsigned int vao, RingBuffer* frameData = NULL)
+    {
+        stream = frameData;
+        if (instanceBuffer == 0) {
+            glGenBuffers(1, &instanceBuffer);
+        }
+        attachInstanceBuffer(vao, instanceBuffer);
+    }
+
+    // points the per-instance attribute locations of `vao` at an array of InstanceData in `buffer`.
+    // The attributes use a binding point of their own, so glBindVertexBuffer can move them to another
+    // buffer or offset without touching the attribute formats.
+    static void attachInstanceBuffer(unsigned int vao, unsigned int buffer)
+    {
+        glBindVertexArray(vao);
+
+        // a matrix attribute takes one location per column
+        for (unsigned int i = 0; i < 4; i++) {
+            unsigned int location = FIRST_LOCATION + i;
+            glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE, (GLuint)(offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+            glVertexAttribBinding(location, BINDING);
+            glEnableVertexAttribArray(location);
+        }
+        for (unsigned int i = 0; i < 3; i++) {
+            unsigned int location = FIRST_LOCATION + 4 + i;
+            glVertexAttribFormat(location, 3, GL_FLOAT, GL_FALSE, (GLuint)(offsetof(InstanceData, normalMatrix) + i * sizeof(glm::vec3)));
+            glVertexAttribBinding(location, BINDING);
+            glEnableVertexAttribArray(location);
+        }
+        // integer attribute, must not go through the float conversion
+        glVertexAttribIFormat(FIRST_LOCATION + 7, 1, GL_UNSIGNED_INT, (GLuint)offsetof(InstanceData, material));
+        glVertexAttribBinding(FIRST_LOCATION + 7, BINDING);
+        glEnableVertexAttribArray(FIRST_LOCATION + 7);
+
+        glVertexBindingDivisor(BINDING, 1);
+        glBindVertexBuffer(BINDING, buffer, 0, sizeof(InstanceData));
+        glBindVertexArray(0);
+    }
+
+    // Geometry drawn from a VAO without the instance arrays (pre-transformed static batches) reads the
+    // same attribute locations as constants; this sets them, for every such draw until changed.
+    static void setConstantInstance(const glm::mat4& model, unsigned int material = 0)
+    {
+        InstanceData instance = makeInstance(model, material);
+        for (unsigned int i = 0; i < 4; i++) {
+            glVertexAttrib4fv(FIRST_LOCATION + i, &instance.model[i].x);
+        }
+        for (unsigned int i = 0; i < 3; i++) {
+            glVertexAttrib3fv(FIRST_LOCATION + 4 + i, &instance.normalMatrix[i].x);
+        }
+        glVertexAttribI4ui(FIRST_LOCATION + 7, instance.material, 0, 0, 0);
+    }
+
+    void clear()
+    {
+        instances.clear();
+        mapped = 0;
+        dirty = true;
+    }
+
+    // Instead of add(): `count` instances for this frame, to be written where this returns (e.g. by
+    // TransformSystem::write). With a persistent RingBuffer that is the ring's mapped memory itself,
+    // so nothing is copied at draw time; otherwise it is the renderer's own array, uploaded as
+    // usual. Replaces what add() collected; valid until clear() or the end of the frame.
+    InstanceData* map(size_t count)
+    {
+        instances.clear();
+        if (stream != NULL && stream->persistent()) {
+            streamed = stream->allocate(count * sizeof(InstanceData));
+            streamedFrame = stream->frameNumber();
+            mapped = count;
+            dirty = false;
+            return static_cast<InstanceData*>(streamed.data);
+        }
+        mapped = 0;
+        instances.resize(count);
+        dirty = true;
+        return instances.data();
+    }
+
+    void add(const glm::mat4& model, unsigned int material = 0)
+    {
+        instances.push_back(makeInstance(model, material));
+        dirty = true;
+    }
+
+    static InstanceData makeInstance(const glm::mat4& model, unsigned int material = 0)
+    {
+        InstanceData instance;
+        instance.model = model;
+        // inverse transpose once per instance on the CPU rather than once per vertex in the shader
+        instance.normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+        instance.material = material;
+        return instance;
+    }
+
+    // draws `count` vertices starting at `first` once per instance added since clear()
+    void drawArrays(unsigned int vao, GLenum mode, GLint first, GLsizei count)
+    {
+        if (size() == 0) {
+            return;
+        }
+        upload();
+        bind(vao);
+        glDrawArraysInstanced(mode, first, count, (GLsizei)size());
+    }
+
+    // indexed variant, `offset` is a byte offset into the VAO's element buffer
+    void drawElements(unsigned int vao, GLenum mode, GLsizei count, GLenum type, size_t offset = 0)
+    {
+        if (size() == 0) {
+            return;
+        }
+        upload();
+        bind(vao);
+        glDrawElementsInstanced(mode, count, type, (void*)offset, (GLsizei)size());
+    }
+
+    size_t size() const { return mapped > 0 ? mapped : instances.size(); }
+
+    void destroy()
+    {
+        glDeleteBuffers(1, &instanceBuffer);
+        instanceBuffer = 0;
+        capacity = 0;
+    }
+
+private:
+    // only uploads when the instances changed, so drawing the same set through several VAOs is free
+    void upload()
+    {
+        // map() put them in the ring already
+        if (mapped > 0) {
+            return;
+        }
+        if (stream != NULL) {
+            // a ring allocation only lives for the frame it was made in
+            if (dirty || streamedFrame != stream->frameNumber()) {
+                streamed = stream->upload(instances.data(), instances.size() * sizeof(InstanceData));
+                streamedFrame = stream->frameNumber();
+                dirty = false;
+            }
+            return;
+        }
+        if (!dirty) {
+            return;
+        }
+        size_t bytes = instances.size() * sizeof(InstanceData);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        if (bytes > capacity) {
+            capacity = bytes;
+            glBufferData(GL_ARRAY_BUFFER, capacity, instances.data(), GL_STREAM_DRAW);
+        } else {
+            // orphan the old storage so we don't wait for last frame's draws to finish reading it
+            glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances.data());
+        }
+        dirty = false;
+    }
+
+    void bind(unsigned int vao)
+    {
+        glBindVertexArray(vao);
+        if (stream != NULL) {
+            glBindVertexBuffer(BINDING, streamed.buffer, streamed.offset, sizeof(InstanceData));
+        } else {
+            glBindVertexBuffer(BINDING, instanceBuffer, 0, sizeof(InstanceData));
+        }
+    }
+
+    std::vector<InstanceData> instances;
+    // instances map() handed out in the ring, 0 when they are in `instances`
+    size_t mapped = 0;
+    unsigned int instanceBuffer = 0;
+    size_t capacity = 0;
+    bool dirty = true;
+    RingBuffer* stream = NULL;
+    RingAllocation streamed;
+    unsigned long long streamedFrame = 0;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <frustum.h>
+#include <lighting.h>
+#include <ringBuffer.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LIGHT_MANAGER_SSE 1
+#endif
+
+// storage binding of the per-object light lists (ObjectLights[]), one entry per instance
+const unsigned int OBJECT_LIGHTS_BINDING = 4;
+
+// Light-to-object assignment on the CPU. Every frame the point lights (PointLightData, range in
+// position.w) are tested against the objects' bounding spheres, four lights at a time from
+// structure-of-arrays copies of their positions and ranges, and each object gets the short list of
+// lights that reach it; an object reached by more than an entry holds keeps the ones it is deepest
+// inside, by distance over reach. The lists go to the frame ring in instance order, so an instanced draw finds
+// its own with gl_InstanceID:
+//
+//     struct ObjectLights { uint count; uint lights[15]; };
+//     layout (std430, binding = 4) readonly buffer ObjectLightLists { ObjectLights objectLights[]; };
+//
+//     lights.setLights(pointLights);
+//     lights.clearObjects();
+//     for (...) { instances.add(model); lights.addObject(model, bounds); }
+//     lights.assign(frameData);                     // binds the lists at OBJECT_LIGHTS_BINDING
+class LightManager
+{
+public:
+    // an entry is a count and this many indices, 64 bytes; the farthest lights past it are dropped
+    static const unsigned int MAX_LIGHTS_PER_OBJECT = 15;
+
+    void setLights(const std::vector<PointLightData>& lights)
+    {
+        lightCount = (unsigned int)lights.size();
+        // padded to whole batches; the padding lanes are masked off in assign()
+        size_t padded = (lightCount + 3) & ~3u;
+        lightX.assign(padded, 0.0f);
+        lightY.assign(padded, 0.0f);
+        lightZ.assign(padded, 0.0f);
+        lightRange.assign(padded, 0.0f);
+        for (unsigned int i = 0; i < lightCount; i++) {
+            lightX[i] = lights[i].position.x;
+            lightY[i] = lights[i].position.y;
+            lightZ[i] = lights[i].position.z;
+            lightRange[i] = lights[i].position.w;
+        }
+    }
+
+    void clearObjects()
+    {
+        objects.clear();
+    }
+
+    // `bounds` is the mesh's bounding sphere (see boundingSphere), `model` the instance's transform
+    void addObject(const glm::mat4& model, const glm::vec4& bounds)
+    {
+        objects.push_back(transformSphere(model, bounds));
+    }
+
+    // fills the lists of the objects added since clearObjects() and binds them for this frame's draws
+    void assign(RingBuffer* frameData)
+    {
+        lists.assign(objects.size() * ENTRY_SIZE, 0);
+        assignedLights = 0;
+        droppedLights = 0;
+        for (size_t object = 0; object < objects.size(); object++) {
+            const glm::vec4& sphere = objects[object];
+            candidates.clear();
+            for (unsigned int batch = 0; batch < lightCount; batch += 4) {
+                unsigned int hits = testBatch(sphere, batch);
+                // lanes past the last light are padding
+                hits &= (1u << std::min(4u, lightCount - batch)) - 1u;
+                for (unsigned int lane = 0; hits != 0; lane++, hits >>= 1) {
+                    if ((hits & 1u) != 0) {
+                        unsigned int i = batch + lane;
+                        glm::vec3 d = glm::vec3(lightX[i], lightY[i], lightZ[i]) - glm::vec3(sphere);
+                        float reach = lightRange[i] + sphere.w;
+                        // (distance / reach)^2, 0 at the light and 1 at the edge of its reach
+                        candidates.push_back(std::make_pair(glm::dot(d, d) / (reach * reach), i));
+                    }
+                }
+            }
+            if (candidates.size() > MAX_LIGHTS_PER_OBJECT) {
+                std::partial_sort(candidates.begin(), candidates.begin() + MAX_LIGHTS_PER_OBJECT, candidates.end());
+                droppedLights += (unsigned int)candidates.size() - MAX_LIGHTS_PER_OBJECT;
+                candidates.resize(MAX_LIGHTS_PER_OBJECT);
+            }
+            unsigned int* entry = &lists[object * ENTRY_SIZE];
+            entry[0] = (unsigned int)candidates.size();
+            for (size_t c = 0; c < candidates.size(); c++) {
+                entry[1 + c] = candidates[c].second;
+            }
+            assignedLights += entry[0];
+        }
+        if (!lists.empty()) {
+            RingBuffer::bindStorage(OBJECT_LIGHTS_BINDING, frameData->upload(lists.data(), lists.size() * sizeof(unsigned int), frameData->storageAlignment()));
+        }
+    }
+
+    // lights the last assign() handed out, over all objects, e.g. for an average per object
+    unsigned int assignedLightCount() const { return assignedLights; }
+    // lights the last assign() found reaching an object whose list was already full
+    unsigned int droppedLightCount() const { return droppedLights; }
+    size_t objectCount() const { return objects.size(); }
+
+private:
+    static const unsigned int ENTRY_SIZE = 1 + MAX_LIGHTS_PER_OBJECT;
+
+    // bit i set when light batch + i reaches the sphere: |light - center| <= range + radius
+    unsigned int testBatch(const glm::vec4& sphere, unsigned int batch) const
+    {
+#ifdef LIGHT_MANAGER_SSE
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&lightX[batch]), _mm_set1_ps(sphere.x));
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&lightY[batch]), _mm_set1_ps(sphere.y));
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(&lightZ[batch]), _mm_set1_ps(sphere.z));
+        __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 reach = _mm_add_ps(_mm_loadu_ps(&lightRange[batch]), _mm_set1_ps(sphere.w));
+        return (unsigned int)_mm_movemask_ps(_mm_cmple_ps(distance2, _mm_mul_ps(reach, reach)));
+#else
+        unsigned int hits = 0;
+        for (unsigned int lane = 0; lane < 4; lane++) {
+            unsigned int i = batch + lane;
+            glm::vec3 d = glm::vec3(lightX[i], lightY[i], lightZ[i]) - glm::vec3(sphere);
+            float reach = lightRange[i] + sphere.w;
+            hits |= (glm::dot(d, d) <= reach * reach ? 1u : 0u) << lane;
+        }
+        return hits;
+#endif
+    }
+
+    unsigned int lightCount = 0;
+    std::vector<float> lightX;
+    std::vector<float> lightY;
+    std::vector<float> lightZ;
+    std::vector<float> lightRange;
+    // world-space bounding spheres, in instance order
+    std::vector<glm::vec4> objects;
+    std::vector<unsigned int> lists;
+    // an object's reaching lights, (distance / reach)^2 and index, kept to save reallocating
+    std::vector<std::pair<float, unsigned int>> candidates;
+    unsigned int assignedLights = 0;
+    unsigned int droppedLights = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// How the multiple-light demos shade their point lights
+enum LightingPath {
+    // every fragment evaluates every light
+    LIGHTING_FORWARD,
+    // lights are binned into a froxel grid by a compute shader, fragments only read their cluster's list
+    LIGHTING_CLUSTERED,
+    // surfaces go to a G-buffer (see GBuffer) first, then one full-screen pass lights each visible
+    // pixel once, whatever the overdraw, with the point lights of its cluster
+    LIGHTING_DEFERRED,
+    // Forward+: a depth prepass bounds every 16x16 tile, a compute shader lists the lights reaching
+    // into it, fragments read their tile's list (see TiledLighting)
+    LIGHTING_TILED
+};
+
+// Process-wide settings, e.g. from scene-runner's command line; read by the scenes in init()
+struct LightingOptions {
+    LightingPath path = LIGHTING_FORWARD;
+    // small animated point lights added on top of a demo's own
+    unsigned int extraPointLights = 0;
+    // forward and clustered paths: lay down depth with a position-only pass first, then shade with
+    // GL_EQUAL so every pixel runs the lighting shader once
+    bool depthPrepass = false;
+    // publish fragment counts and GPU times of the passes to overdrawStats()
+    bool measureOverdraw = false;
+    // light-caster-directional bakes its static cubes' light into a lightmap at load (see
+    // LightmapBaker) and draws them sampling it instead of lighting them per fragment
+    bool lightmaps = false;
+    // lighting-specular-(gouraud)-rotating stops its light and bakes the cube's lighting into vertex
+    // colours at load (see VertexLightBaker)
+    bool bakedVertexLighting = false;
+    // light-caster-spotlight-(flashlight) turns its cubes in the vertex shader from transforms uploaded
+    // at load (see SpinAnimation) instead of building their matrices every frame
+    bool gpuAnimation = false;
+};
+
+inline LightingOptions& lightingOptions()
+{
+    static LightingOptions options;
+    return options;
+}
+
+// storage binding of the point lights (PointLightData[]), uploaded once per frame
+const unsigned int POINT_LIGHTS_BINDING = 1;
+
+// std430 point light as the shaders' PointLights storage buffer holds it
+struct PointLightData {
+    // xyz position, w range (see pointLightRange)
+    glm::vec4 position;
+    // rgb colour, w attenuation term
+    glm::vec4 ambient;   // w = constant
+    glm::vec4 diffuse;   // w = linear
+    glm::vec4 specular;  // w = quadratic
+};
+static_assert(sizeof(PointLightData) == 64, "PointLightData must match the std430 layout of PointLight");
+
+// Distance at which 1 / (constant + linear * d + quadratic * d^2) has brought the brightest colour
+// component down to 5/256 of itself, the cut-off the light's influence ends at
+inline float pointLightRange(float constant, float linear, float quadratic, float brightest)
+{
+    const float threshold = 256.0f / 5.0f;
+    float c = constant - threshold * brightest;
+    if (quadratic <= 0.0f) {
+        return linear > 0.0f ? -c / linear : 1e30f;
+    }
+    return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+}
+
+inline PointLightData makePointLight(const glm::vec3& position, const glm::vec3& ambient, const glm::vec3& diffuse,
+    const glm::vec3& specular, float constant, float linear, float quadratic)
+{
+    float brightest = std::max(std::max(diffuse.r, std::max(diffuse.g, diffuse.b)), std::max(specular.r, std::max(specular.g, specular.b)));
+    PointLightData light;
+    light.position = glm::vec4(position, pointLightRange(constant, linear, quadratic, brightest));
+    light.ambient = glm::vec4(ambient, constant);
+    light.diffuse = glm::vec4(diffuse, linear);
+    light.specular = glm::vec4(specular, quadratic);
+    return light;
+}
+
+// The `i`th of lightingOptions().extraPointLights at `time`: a small light of a fixed pseudo-random
+// colour circling a fixed pseudo-random point of the box around the demos' cubes, reaching ~2.4 units
+inline PointLightData extraPointLight(unsigned int i, double time)
+{
+    unsigned int hash = i * 2654435761u;
+    float u = (hash & 0xFF) / 255.0f;
+    float v = ((hash >> 8) & 0xFF) / 255.0f;
+    float w = ((hash >> 16) & 0xFF) / 255.0f;
+    glm::vec3 center(-10.0f + 20.0f * u, -6.0f + 14.0f * v, -20.0f + 24.0f * w);
+    // in double: the two circling rates share no period to wrap the angle at
+    double angle = time * (0.5 + w) + 6.283185307179586 * v;
+    glm::vec3 position = center + glm::vec3((float)std::cos(angle), 0.5f * (float)std::sin(angle * 1.3), (float)std::sin(angle)) * (0.5f + u);
+    glm::vec3 colour = glm::clamp(glm::abs(glm::mod(u * 6.0f + glm::vec3(0.0f, 4.0f, 2.0f), 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f);
+    return makePointLight(position, glm::vec3(0.0f), colour * 0.25f, colour * 0.25f, 1.0f, 0.7f, 1.8f);
+}
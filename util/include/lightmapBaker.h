@@ -0,0 +1,643 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <float4.h>
+#include <mesh.h>
+#include <parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// attribute location of the lightmap coordinates, after InstancedRenderer's 3..10
+const unsigned int LIGHTMAP_UV_LOCATION = 11;
+// texture unit lightmapped shaders find the atlas on
+const unsigned int LIGHTMAP_UNIT = 6;
+
+// The last bake, for scene-runner's report
+struct LightmapStats {
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int charts = 0;
+    unsigned int triangles = 0;
+    unsigned long long rays = 0;
+    unsigned int threads = 0;
+    double milliseconds = 0.0;
+};
+
+inline LightmapStats& lightmapStats()
+{
+    static LightmapStats stats;
+    return stats;
+}
+
+// Four rays traced together: origins, directions, the distance each may travel, and on return from
+// RayBVH::intersect the triangle each hit (-1 for none) with its barycentrics
+struct RayPacket {
+    Float4 ox, oy, oz;
+    Float4 dx, dy, dz;
+    Float4 tmax;
+    int triangle[4] = { -1, -1, -1, -1 };
+    float u[4] = {};
+    float v[4] = {};
+};
+
+// Bounding volume hierarchy over a triangle soup, traced four rays at a time: a node is entered when
+// any ray of the packet hits its box, and each triangle is tested against the whole packet at once.
+// Built by median splits along the longest axis of the triangles' centroids, at most LEAF_SIZE a leaf.
+class RayBVH
+{
+public:
+    static const unsigned int LEAF_SIZE = 4;
+
+    // `positions` three floats a vertex, `indices` three a triangle
+    void build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+    {
+        size_t count = indices.size() / 3;
+        triangles.resize(count);
+        std::vector<glm::vec3> centroids(count);
+        order.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            Triangle& t = triangles[i];
+            t.v0 = positions[indices[i * 3]];
+            t.e1 = positions[indices[i * 3 + 1]] - t.v0;
+            t.e2 = positions[indices[i * 3 + 2]] - t.v0;
+            centroids[i] = t.v0 + (t.e1 + t.e2) / 3.0f;
+            order[i] = (unsigned int)i;
+        }
+        nodes.clear();
+        nodes.push_back(Node());
+        if (count > 0) {
+            split(0, 0, (unsigned int)count, centroids);
+        }
+    }
+
+    // closest hits of the packet's rays whose lane is set in `active`; with `anyHit`, a ray stops at
+    // its first hit, which is enough for shadow rays
+    void intersect(RayPacket& packet, int active = 0xF, bool anyHit = false) const
+    {
+        if (triangles.empty()) {
+            return;
+        }
+        Float4 one(1.0f);
+        Float4 invX = one / packet.dx;
+        Float4 invY = one / packet.dy;
+        Float4 invZ = one / packet.dz;
+        unsigned int stack[64];
+        unsigned int depth = 0;
+        stack[depth++] = 0;
+        while (depth > 0 && active != 0) {
+            const Node& node = nodes[stack[--depth]];
+            // slab test of all four rays against the node's box
+            Float4 t0x = (Float4(node.low.x) - packet.ox) * invX, t1x = (Float4(node.high.x) - packet.ox) * invX;
+            Float4 t0y = (Float4(node.low.y) - packet.oy) * invY, t1y = (Float4(node.high.y) - packet.oy) * invY;
+            Float4 t0z = (Float4(node.low.z) - packet.oz) * invZ, t1z = (Float4(node.high.z) - packet.oz) * invZ;
+            Float4 enter = max4(max4(min4(t0x, t1x), min4(t0y, t1y)), max4(min4(t0z, t1z), Float4(0.0f)));
+            Float4 exit = min4(min4(max4(t0x, t1x), max4(t0y, t1y)), min4(max4(t0z, t1z), packet.tmax));
+            if ((mask4(enter <= exit) & active) == 0) {
+                continue;
+            }
+            if (node.count == 0) {
+                stack[depth++] = node.first;
+                stack[depth++] = node.first + 1;
+                continue;
+            }
+            for (unsigned int i = node.first; i < node.first + node.count; i++) {
+                active &= ~intersectTriangle(packet, order[i], active, anyHit);
+            }
+        }
+    }
+
+private:
+    struct Triangle {
+        glm::vec3 v0, e1, e2;
+    };
+
+    struct Node {
+        glm::vec3 low = glm::vec3(0.0f);
+        glm::vec3 high = glm::vec3(0.0f);
+        // a leaf's triangles in order[], or an inner node's children at first and first + 1
+        unsigned int first = 0;
+        unsigned int count = 0;
+    };
+
+    void split(unsigned int nodeIndex, unsigned int first, unsigned int count, const std::vector<glm::vec3>& centroids)
+    {
+        glm::vec3 low(1e30f), high(-1e30f), centroidLow(1e30f), centroidHigh(-1e30f);
+        for (unsigned int i = first; i < first + count; i++) {
+            const Triangle& t = triangles[order[i]];
+            glm::vec3 v1 = t.v0 + t.e1, v2 = t.v0 + t.e2;
+            low = glm::min(low, glm::min(t.v0, glm::min(v1, v2)));
+            high = glm::max(high, glm::max(t.v0, glm::max(v1, v2)));
+            centroidLow = glm::min(centroidLow, centroids[order[i]]);
+            centroidHigh = glm::max(centroidHigh, centroids[order[i]]);
+        }
+        nodes[nodeIndex].low = low;
+        nodes[nodeIndex].high = high;
+        if (count <= LEAF_SIZE) {
+            nodes[nodeIndex].first = first;
+            nodes[nodeIndex].count = count;
+            return;
+        }
+        glm::vec3 extent = centroidHigh - centroidLow;
+        int axis = extent.x > extent.y && extent.x > extent.z ? 0 : (extent.y > extent.z ? 1 : 2);
+        unsigned int half = count / 2;
+        std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+            [&](unsigned int a, unsigned int b) { return centroids[a][axis] < centroids[b][axis]; });
+        unsigned int children = (unsigned int)nodes.size();
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        nodes[nodeIndex].first = children;
+        nodes[nodeIndex].count = 0;
+        split(children, first, half, centroids);
+        split(children + 1, first + half, count - half, centroids);
+    }
+
+    // Moller-Trumbore for the four rays; returns the lanes that hit, which with anyHit are done
+    int intersectTriangle(RayPacket& packet, unsigned int index, int active, bool anyHit) const
+    {
+        const Triangle& t = triangles[index];
+        Float4 e1x(t.e1.x), e1y(t.e1.y), e1z(t.e1.z);
+        Float4 e2x(t.e2.x), e2y(t.e2.y), e2z(t.e2.z);
+        // p = d x e2
+        Float4 px = packet.dy * e2z - packet.dz * e2y;
+        Float4 py = packet.dz * e2x - packet.dx * e2z;
+        Float4 pz = packet.dx * e2y - packet.dy * e2x;
+        Float4 det = e1x * px + e1y * py + e1z * pz;
+        Float4 inverse = Float4(1.0f) / det;
+        Float4 sx = packet.ox - Float4(t.v0.x), sy = packet.oy - Float4(t.v0.y), sz = packet.oz - Float4(t.v0.z);
+        Float4 u = (sx * px + sy * py + sz * pz) * inverse;
+        // q = s x e1
+        Float4 qx = sy * e1z - sz * e1y;
+        Float4 qy = sz * e1x - sx * e1z;
+        Float4 qz = sx * e1y - sy * e1x;
+        Float4 v = (packet.dx * qx + packet.dy * qy + packet.dz * qz) * inverse;
+        Float4 distance = (e2x * qx + e2y * qy + e2z * qz) * inverse;
+        Float4 zero(0.0f);
+        Float4 hit = (Float4(1e-12f) < abs4(det)) & (zero <= u) & (zero <= v) & (u + v <= Float4(1.0f))
+            & (Float4(1e-4f) < distance) & (distance < packet.tmax);
+        int lanes = mask4(hit) & active;
+        if (lanes == 0) {
+            return 0;
+        }
+        packet.tmax = select4(hit, distance, packet.tmax);
+        float us[4], vs[4];
+        u.store(us);
+        v.store(vs);
+        for (int lane = 0; lane < 4; lane++) {
+            if ((lanes & (1 << lane)) != 0) {
+                packet.triangle[lane] = (int)index;
+                packet.u[lane] = us[lane];
+                packet.v[lane] = vs[lane];
+            }
+        }
+        return anyHit ? lanes : 0;
+    }
+
+    std::vector<Triangle> triangles;
+    std::vector<unsigned int> order;
+    std::vector<Node> nodes;
+};
+
+// Bakes the light reaching static geometry into a lightmap atlas, on the CPU, across all cores.
+//
+// Layout: the triangles sharing vertices form charts (a welded cube's faces are six charts), each
+// projected onto the plane of its average normal at texelsPerUnit texels per world unit, padded and
+// shelf-packed into the atlas; uv2 gets every vertex's atlas coordinates, so the mesh must be welded
+// so no vertex is shared between charts that aren't one plane.
+//
+// Lighting, per covered texel: direct light from the directional lights with one shadow ray each, plus
+// `samples` cosine-distributed rays; a ray that escapes brings in the sky, one that hits brings in
+// what the surface it hits reflects (albedo times its texel's light of the previous bounce). The rays
+// are traced once, four at a time through a RayBVH; the bounces then only re-gather through the
+// recorded hits. A texel holds irradiance over pi in rgb, what the diffuse texture is multiplied by,
+// and in alpha how much of the first light's disc is unoccluded, for specular.
+//
+//     baker.setGeometry(batch.mesh());                 // world space, with normals
+//     baker.addDirectionalLight(direction, colour);
+//     baker.bake();
+//     unsigned int lightmap = baker.createTexture();
+//     baker.attachUV2(VAO);                            // location LIGHTMAP_UV_LOCATION
+class LightmapBaker
+{
+public:
+    struct Settings {
+        float texelsPerUnit = 16.0f;
+        // hemisphere rays per texel, traced in packets of four
+        unsigned int samples = 64;
+        unsigned int bounces = 2;
+        glm::vec3 sky = glm::vec3(0.1f);
+        // of the surfaces light bounces off, all of them alike
+        glm::vec3 albedo = glm::vec3(0.5f);
+        // 0: every core
+        unsigned int threads = 0;
+    };
+    // texels around every chart, against bilinear filtering bleeding the neighbours in
+    static const unsigned int PADDING = 2;
+
+    Settings settings;
+
+    void setGeometry(const Mesh& mesh)
+    {
+        unsigned int stride = mesh.floatsPerVertex;
+        positions.resize(mesh.vertexCount());
+        normals.resize(mesh.vertexCount());
+        for (size_t v = 0; v < mesh.vertexCount(); v++) {
+            const float* vertex = &mesh.vertices[v * stride];
+            positions[v] = glm::vec3(vertex[0], vertex[1], vertex[2]);
+            normals[v] = stride >= 6 ? glm::normalize(glm::vec3(vertex[3], vertex[4], vertex[5])) : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        indices = mesh.indices;
+    }
+
+    // `direction` the way the light travels
+    void addDirectionalLight(const glm::vec3& direction, const glm::vec3& colour)
+    {
+        lights.push_back(DirectionalLight{ glm::normalize(direction), colour });
+    }
+
+    void bake()
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        unsigned int threads = settings.threads != 0 ? settings.threads : workerThreads();
+        layOut();
+        findTexels();
+        bvh.build(positions, indices);
+        traceDirect(threads);
+        traceHemisphere(threads);
+
+        // bounce 0 is the direct light and the sky; every further one adds light off the surfaces
+        std::vector<glm::vec3> previous(texels.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> current(texels.size());
+        for (unsigned int bounce = 0; bounce <= settings.bounces; bounce++) {
+            parallelFor(texels.size(), 64, threads, [&](size_t i) {
+                glm::vec3 gathered(0.0f);
+                for (unsigned int s = 0; s < settings.samples; s++) {
+                    int hit = hits[i * settings.samples + s];
+                    gathered += hit < 0 ? settings.sky : settings.albedo * previous[hit];
+                }
+                current[i] = direct[i] + gathered / (float)settings.samples;
+            });
+            std::swap(previous, current);
+        }
+
+        atlas.assign((size_t)width * height, glm::vec4(0.0f));
+        for (size_t i = 0; i < texels.size(); i++) {
+            atlas[texels[i].index] = glm::vec4(previous[i], visibility[i]);
+        }
+
+        LightmapStats& stats = lightmapStats();
+        stats.width = width;
+        stats.height = height;
+        stats.charts = chartCount;
+        stats.triangles = (unsigned int)(indices.size() / 3);
+        stats.rays = (unsigned long long)texels.size() * (settings.samples + lights.size());
+        stats.threads = threads;
+        stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // the atlas as an RGBA16F texture, bilinear filtered
+    unsigned int createTexture() const
+    {
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, atlas.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return texture;
+    }
+
+    // uploads uv2 and points LIGHTMAP_UV_LOCATION of `vao` at it, indexed like the baked mesh's
+    // vertices from its MeshBuffer::vertexBase(), which the buffer leaves unused space for; returns the
+    // buffer, for the caller to delete
+    unsigned int attachUV2(unsigned int vao, unsigned int vertexBase = 0) const
+    {
+        unsigned int buffer;
+        glGenBuffers(1, &buffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, (vertexBase + uv2.size()) * sizeof(glm::vec2), NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, vertexBase * sizeof(glm::vec2), uv2.size() * sizeof(glm::vec2), uv2.data());
+        glVertexAttribPointer(LIGHTMAP_UV_LOCATION, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+        glEnableVertexAttribArray(LIGHTMAP_UV_LOCATION);
+        glBindVertexArray(0);
+        return buffer;
+    }
+
+    // per vertex, atlas coordinates in [0, 1]
+    std::vector<glm::vec2> uv2;
+    // width x height texels, rows bottom up as GL has them
+    std::vector<glm::vec4> atlas;
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+private:
+    struct DirectionalLight {
+        glm::vec3 direction;
+        glm::vec3 colour;
+    };
+
+    // a covered texel: where on the surface it sits
+    struct Texel {
+        unsigned int index;
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+
+    // uniform in [0, 1) from a hash of the three keys, so a bake is the same on any number of threads
+    static float random(unsigned int a, unsigned int b, unsigned int c)
+    {
+        unsigned int h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u) * 0x85EBCA77u ^ (c + 0x165667B1u) * 0xC2B2AE3Du;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return (h >> 8) * (1.0f / 16777216.0f);
+    }
+
+    static unsigned int findRoot(std::vector<unsigned int>& parent, unsigned int i)
+    {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    // charts, their projection and their place in the atlas; fills uv2 and chartOf
+    void layOut()
+    {
+        size_t triangleCount = indices.size() / 3;
+        std::vector<unsigned int> parent(positions.size());
+        for (size_t i = 0; i < parent.size(); i++) {
+            parent[i] = (unsigned int)i;
+        }
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 1; k < 3; k++) {
+                parent[findRoot(parent, indices[t * 3 + k])] = findRoot(parent, indices[t * 3]);
+            }
+        }
+
+        // a chart per root, with the area-weighted normal of its triangles
+        std::vector<int> chartOfRoot(positions.size(), -1);
+        std::vector<glm::vec3> chartNormal;
+        chartOf.assign(triangleCount, 0);
+        for (size_t t = 0; t < triangleCount; t++) {
+            unsigned int root = findRoot(parent, indices[t * 3]);
+            if (chartOfRoot[root] < 0) {
+                chartOfRoot[root] = (int)chartNormal.size();
+                chartNormal.push_back(glm::vec3(0.0f));
+            }
+            chartOf[t] = (unsigned int)chartOfRoot[root];
+            const glm::vec3& a = positions[indices[t * 3]];
+            chartNormal[chartOf[t]] += glm::cross(positions[indices[t * 3 + 1]] - a, positions[indices[t * 3 + 2]] - a);
+        }
+        chartCount = (unsigned int)chartNormal.size();
+
+        // each chart's vertices projected onto its plane, in texels
+        std::vector<glm::vec2> projected(positions.size());
+        std::vector<glm::vec2> low(chartCount, glm::vec2(1e30f)), high(chartCount, glm::vec2(-1e30f));
+        std::vector<glm::vec3> axisU(chartCount), axisV(chartCount);
+        for (unsigned int c = 0; c < chartCount; c++) {
+            glm::vec3 n = glm::length(chartNormal[c]) > 0.0f ? glm::normalize(chartNormal[c]) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::vec3 helper = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            axisU[c] = glm::normalize(glm::cross(helper, n));
+            axisV[c] = glm::cross(n, axisU[c]);
+        }
+        for (size_t v = 0; v < positions.size(); v++) {
+            int c = chartOfRoot[findRoot(parent, (unsigned int)v)];
+            if (c < 0) {
+                continue;
+            }
+            projected[v] = glm::vec2(glm::dot(positions[v], axisU[c]), glm::dot(positions[v], axisV[c])) * settings.texelsPerUnit;
+            low[c] = glm::min(low[c], projected[v]);
+            high[c] = glm::max(high[c], projected[v]);
+        }
+
+        // shelf packing, tallest charts first
+        std::vector<glm::uvec2> size(chartCount);
+        std::vector<unsigned int> byHeight(chartCount);
+        size_t area = 0;
+        unsigned int widest = 0;
+        for (unsigned int c = 0; c < chartCount; c++) {
+            glm::vec2 extent = glm::max(high[c] - low[c], glm::vec2(1.0f));
+            size[c] = glm::uvec2(glm::ceil(extent)) + glm::uvec2(2 * PADDING);
+            area += (size_t)size[c].x * size[c].y;
+            widest = std::max(widest, size[c].x);
+            byHeight[c] = c;
+        }
+        std::sort(byHeight.begin(), byHeight.end(), [&](unsigned int a, unsigned int b) { return size[a].y > size[b].y; });
+        width = 4;
+        while ((size_t)width * width < area || width < widest) {
+            width *= 2;
+        }
+        std::vector<glm::uvec2> origin(chartCount);
+        unsigned int x = 0, y = 0, shelf = 0;
+        for (unsigned int i = 0; i < chartCount; i++) {
+            unsigned int c = byHeight[i];
+            if (x + size[c].x > width) {
+                x = 0;
+                y += shelf;
+                shelf = 0;
+            }
+            origin[c] = glm::uvec2(x, y);
+            x += size[c].x;
+            shelf = std::max(shelf, size[c].y);
+        }
+        height = (y + shelf + 3) & ~3u;
+
+        texelUV.assign(positions.size(), glm::vec2(0.0f));
+        uv2.assign(positions.size(), glm::vec2(0.0f));
+        for (size_t v = 0; v < positions.size(); v++) {
+            int c = chartOfRoot[findRoot(parent, (unsigned int)v)];
+            if (c < 0) {
+                continue;
+            }
+            texelUV[v] = glm::vec2(origin[c]) + glm::vec2((float)PADDING) + (projected[v] - low[c]);
+            uv2[v] = texelUV[v] / glm::vec2((float)width, (float)height);
+        }
+        chartOrigin = origin;
+        chartSize = size;
+    }
+
+    // the surface point under every texel of every chart; texels of the padding take the closest
+    // point of the chart, so filtering at chart edges reads plausible light
+    void findTexels()
+    {
+        std::vector<std::vector<unsigned int>> chartTriangles(chartCount);
+        for (size_t t = 0; t < chartOf.size(); t++) {
+            chartTriangles[chartOf[t]].push_back((unsigned int)t);
+        }
+        texels.clear();
+        for (unsigned int c = 0; c < chartCount; c++) {
+            for (unsigned int ty = 0; ty < chartSize[c].y; ty++) {
+                for (unsigned int tx = 0; tx < chartSize[c].x; tx++) {
+                    glm::vec2 p = glm::vec2(chartOrigin[c] + glm::uvec2(tx, ty)) + glm::vec2(0.5f);
+                    float best = 1e30f;
+                    Texel texel;
+                    texel.index = (chartOrigin[c].y + ty) * width + chartOrigin[c].x + tx;
+                    for (size_t k = 0; k < chartTriangles[c].size(); k++) {
+                        const unsigned int* tri = &indices[chartTriangles[c][k] * 3];
+                        glm::vec2 a = texelUV[tri[0]], b = texelUV[tri[1]], d = texelUV[tri[2]];
+                        float area = (b.x - a.x) * (d.y - a.y) - (d.x - a.x) * (b.y - a.y);
+                        if (std::abs(area) < 1e-8f) {
+                            continue;
+                        }
+                        float w1 = ((p.x - a.x) * (d.y - a.y) - (d.x - a.x) * (p.y - a.y)) / area;
+                        float w2 = ((b.x - a.x) * (p.y - a.y) - (p.x - a.x) * (b.y - a.y)) / area;
+                        float w0 = 1.0f - w1 - w2;
+                        // how far outside the triangle, 0 inside
+                        float outside = std::max(0.0f, -w0) + std::max(0.0f, -w1) + std::max(0.0f, -w2);
+                        if (outside < best) {
+                            best = outside;
+                            w0 = std::max(w0, 0.0f);
+                            w1 = std::max(w1, 0.0f);
+                            w2 = std::max(w2, 0.0f);
+                            float sum = w0 + w1 + w2;
+                            texel.position = (positions[tri[0]] * w0 + positions[tri[1]] * w1 + positions[tri[2]] * w2) / sum;
+                            texel.normal = glm::normalize(normals[tri[0]] * w0 + normals[tri[1]] * w1 + normals[tri[2]] * w2);
+                        }
+                    }
+                    if (best < 1e30f) {
+                        texels.push_back(texel);
+                    }
+                }
+            }
+        }
+        // the texel index of every atlas position, for the hits to look up
+        texelAt.assign((size_t)width * height, -1);
+        for (size_t i = 0; i < texels.size(); i++) {
+            texelAt[texels[i].index] = (int)i;
+        }
+    }
+
+    // ray origins sit off the surface, away from its own triangles
+    static glm::vec3 offsetOrigin(const Texel& texel)
+    {
+        return texel.position + texel.normal * 1e-3f;
+    }
+
+    // direct light and the first light's visibility, shadow rays four texels at a time
+    void traceDirect(unsigned int threads)
+    {
+        direct.assign(texels.size(), glm::vec3(0.0f));
+        visibility.assign(texels.size(), 1.0f);
+        size_t packets = (texels.size() + 3) / 4;
+        parallelFor(packets, 16, threads, [&](size_t packetIndex) {
+            for (size_t l = 0; l < lights.size(); l++) {
+                RayPacket packet;
+                float o[3][4] = {}, d[3][4];
+                int active = 0;
+                for (int lane = 0; lane < 4; lane++) {
+                    size_t i = std::min(packetIndex * 4 + lane, texels.size() - 1);
+                    glm::vec3 origin = offsetOrigin(texels[i]);
+                    for (int k = 0; k < 3; k++) {
+                        o[k][lane] = origin[k];
+                        d[k][lane] = -lights[l].direction[k];
+                    }
+                    active |= (packetIndex * 4 + lane < texels.size() ? 1 : 0) << lane;
+                }
+                packet.ox = Float4::load(o[0]);
+                packet.oy = Float4::load(o[1]);
+                packet.oz = Float4::load(o[2]);
+                packet.dx = Float4::load(d[0]);
+                packet.dy = Float4::load(d[1]);
+                packet.dz = Float4::load(d[2]);
+                packet.tmax = Float4(1e30f);
+                bvh.intersect(packet, active, true);
+                for (int lane = 0; lane < 4; lane++) {
+                    if ((active & (1 << lane)) == 0) {
+                        continue;
+                    }
+                    size_t i = packetIndex * 4 + lane;
+                    float lit = packet.triangle[lane] < 0 ? 1.0f : 0.0f;
+                    direct[i] += lights[l].colour * std::max(glm::dot(texels[i].normal, -lights[l].direction), 0.0f) * lit;
+                    if (l == 0) {
+                        visibility[i] = lit;
+                    }
+                }
+            }
+        });
+    }
+
+    // the hemisphere rays of every texel, four a packet; records the texel each one lands on
+    void traceHemisphere(unsigned int threads)
+    {
+        unsigned int samples = (settings.samples + 3) & ~3u;
+        settings.samples = samples;
+        hits.assign(texels.size() * samples, -1);
+        parallelFor(texels.size(), 16, threads, [&](size_t i) {
+            const Texel& texel = texels[i];
+            glm::vec3 n = texel.normal;
+            // an orthonormal basis around the normal (Duff et al.)
+            float sign = n.z >= 0.0f ? 1.0f : -1.0f;
+            float a = -1.0f / (sign + n.z);
+            float b = n.x * n.y * a;
+            glm::vec3 tangent(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+            glm::vec3 bitangent(b, sign + n.y * n.y * a, -n.y);
+            glm::vec3 origin = offsetOrigin(texel);
+            for (unsigned int s = 0; s < samples; s += 4) {
+                RayPacket packet;
+                float d[3][4];
+                for (int lane = 0; lane < 4; lane++) {
+                    // cosine distributed: uniform on the disc, lifted onto the hemisphere
+                    float r = std::sqrt(random((unsigned int)i, s + lane, 0));
+                    float phi = 6.2831853f * random((unsigned int)i, s + lane, 1);
+                    glm::vec3 direction = tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi)) + n * std::sqrt(std::max(0.0f, 1.0f - r * r));
+                    for (int k = 0; k < 3; k++) {
+                        d[k][lane] = direction[k];
+                    }
+                }
+                packet.ox = Float4(origin.x);
+                packet.oy = Float4(origin.y);
+                packet.oz = Float4(origin.z);
+                packet.dx = Float4::load(d[0]);
+                packet.dy = Float4::load(d[1]);
+                packet.dz = Float4::load(d[2]);
+                packet.tmax = Float4(1e30f);
+                bvh.intersect(packet);
+                for (int lane = 0; lane < 4; lane++) {
+                    hits[i * samples + s + lane] = packet.triangle[lane] < 0 ? -1 : texelOf(packet.triangle[lane], packet.u[lane], packet.v[lane]);
+                }
+            }
+        });
+    }
+
+    // the texel of the atlas under a hit, -1 (taken as sky) if that texel isn't covered
+    int texelOf(int triangle, float u, float v) const
+    {
+        const unsigned int* tri = &indices[(size_t)triangle * 3];
+        glm::vec2 p = texelUV[tri[0]] * (1.0f - u - v) + texelUV[tri[1]] * u + texelUV[tri[2]] * v;
+        unsigned int x = (unsigned int)std::min(std::max(p.x, 0.0f), (float)width - 1.0f);
+        unsigned int y = (unsigned int)std::min(std::max(p.y, 0.0f), (float)height - 1.0f);
+        return texelAt[(size_t)y * width + x];
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<unsigned int> indices;
+    std::vector<DirectionalLight> lights;
+
+    unsigned int chartCount = 0;
+    std::vector<unsigned int> chartOf;
+    std::vector<glm::uvec2> chartOrigin;
+    std::vector<glm::uvec2> chartSize;
+    // uv2 in texels
+    std::vector<glm::vec2> texelUV;
+
+    RayBVH bvh;
+    std::vector<Texel> texels;
+    std::vector<int> texelAt;
+    std::vector<glm::vec3> direct;
+    std::vector<float> visibility;
+    // per texel, `samples` entries: the texel each hemisphere ray landed on, -1 for the sky
+    std::vector<int> hits;
+};
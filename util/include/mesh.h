@@ -0,0 +1,695 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vertexFormat.h>
+#include <bufferAllocator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Indexed triangle list with interleaved float vertices
+struct Mesh {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int floatsPerVertex = 0;
+
+    size_t vertexCount() const { return floatsPerVertex > 0 ? vertices.size() / floatsPerVertex : 0; }
+};
+
+// Post-transform vertex cache efficiency of an index buffer:
+//   acmr  average cache miss ratio, vertex shader runs per triangle (0.5 is ideal for large grids, 3 is no reuse)
+//   atvr  average transform to vertex ratio, vertex shader runs per unique vertex (1 is ideal)
+struct VertexCacheStats {
+    double acmr = 0.0;
+    double atvr = 0.0;
+};
+
+// simulates a FIFO post-transform cache of `cacheSize` entries over the index buffer
+inline VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = 16)
+{
+    VertexCacheStats stats;
+    if (indices.empty() || vertexCount == 0) {
+        return stats;
+    }
+    // timestamp at which each vertex entered the cache; it is still cached while fewer than cacheSize misses have happened since
+    std::vector<size_t> cachedAt(vertexCount, 0);
+    size_t misses = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        size_t& entry = cachedAt[indices[i]];
+        if (entry == 0 || misses - entry >= cacheSize) {
+            misses++;
+            entry = misses;
+        }
+    }
+    stats.acmr = (double)misses / (indices.size() / 3);
+    stats.atvr = (double)misses / vertexCount;
+    return stats;
+}
+
+// turns a non-indexed triangle list into an indexed one, merging bit-identical vertices
+inline Mesh weldVertices(const float* vertices, size_t vertexCount, unsigned int floatsPerVertex)
+{
+    Mesh mesh;
+    mesh.floatsPerVertex = floatsPerVertex;
+    mesh.indices.reserve(vertexCount);
+
+    // FNV-1a over the vertex bytes, collisions are resolved by comparing the floats
+    std::unordered_multimap<size_t, unsigned int> seen;
+    size_t vertexBytes = floatsPerVertex * sizeof(float);
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* vertex = vertices + v * floatsPerVertex;
+        const unsigned char* bytes = (const unsigned char*)vertex;
+        size_t hash = 14695981039346656037ull;
+        for (size_t b = 0; b < vertexBytes; b++) {
+            hash = (hash ^ bytes[b]) * 1099511628211ull;
+        }
+
+        unsigned int index = (unsigned int)mesh.vertexCount();
+        auto range = seen.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (std::memcmp(&mesh.vertices[it->second * floatsPerVertex], vertex, vertexBytes) == 0) {
+                index = it->second;
+                break;
+            }
+        }
+        if (index == mesh.vertexCount()) {
+            mesh.vertices.insert(mesh.vertices.end(), vertex, vertex + floatsPerVertex);
+            seen.insert(std::make_pair(hash, index));
+        }
+        mesh.indices.push_back(index);
+    }
+    return mesh;
+}
+
+// Reorders triangles so consecutive triangles reuse recently transformed vertices.
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation": greedily emits the triangle whose vertices
+// score highest, where a vertex scores for being recently used and for having few triangles left.
+inline void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+{
+    const int cacheSize = 32;
+    const float cacheDecayPower = 1.5f;
+    const float lastTriangleScore = 0.75f;
+    const float valenceBoostScale = 2.0f;
+    const float valenceBoostPower = 0.5f;
+
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // triangles that use each vertex, as ranges into one flat array
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < indices.size(); i++) {
+        remaining[indices[i]]++;
+    }
+    std::vector<unsigned int> firstTriangle(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+    }
+    std::vector<unsigned int> vertexTriangles(indices.size());
+    std::vector<unsigned int> filled(vertexCount, 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = indices[t * 3 + k];
+            vertexTriangles[firstTriangle[v] + filled[v]++] = (unsigned int)t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    auto vertexScore = [&](unsigned int v) -> float {
+        if (remaining[v] == 0) {
+            return -1.0f;
+        }
+        float score = 0.0f;
+        int position = cachePosition[v];
+        if (position >= 0) {
+            if (position < 3) {
+                // used by the triangle just emitted; a fixed score so it isn't immediately reused in a strip-like order
+                score = lastTriangleScore;
+            } else {
+                score = std::pow(1.0f - (float)(position - 3) / (cacheSize - 3), cacheDecayPower);
+            }
+        }
+        return score + valenceBoostScale * std::pow((float)remaining[v], -valenceBoostPower);
+    };
+
+    std::vector<float> score(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        score[v] = vertexScore((unsigned int)v);
+    }
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> nextCache;
+    size_t scanStart = 0;
+    long best = -1;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (best < 0) {
+            // nothing in the cache is connected to anything left, take the next unused triangle
+            while (emitted[scanStart]) {
+                scanStart++;
+            }
+            best = (long)scanStart;
+        }
+
+        const unsigned int* triangle = &indices[best * 3];
+        emitted[best] = true;
+        output.insert(output.end(), triangle, triangle + 3);
+
+        // the emitted triangle's vertices go to the front of the LRU cache and lose one remaining triangle
+        nextCache.assign(triangle, triangle + 3);
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = triangle[k];
+            unsigned int* begin = &vertexTriangles[firstTriangle[v]];
+            unsigned int* end = begin + remaining[v];
+            std::iter_swap(std::find(begin, end, (unsigned int)best), end - 1);
+            remaining[v]--;
+        }
+        for (size_t i = 0; i < cache.size(); i++) {
+            unsigned int v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                nextCache.push_back(v);
+            }
+        }
+        for (size_t i = cacheSize; i < nextCache.size(); i++) {
+            cachePosition[nextCache[i]] = -1;
+            score[nextCache[i]] = vertexScore(nextCache[i]);
+        }
+        if (nextCache.size() > (size_t)cacheSize) {
+            nextCache.resize(cacheSize);
+        }
+        cache.swap(nextCache);
+
+        // rescore the cached vertices and their triangles, and pick the best of those next
+        for (size_t i = 0; i < cache.size(); i++) {
+            cachePosition[cache[i]] = (int)i;
+            score[cache[i]] = vertexScore(cache[i]);
+        }
+        best = -1;
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < cache.size(); i++) {
+            unsigned int v = cache[i];
+            for (unsigned int j = 0; j < remaining[v]; j++) {
+                unsigned int t = vertexTriangles[firstTriangle[v] + j];
+                triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = (long)t;
+                }
+            }
+        }
+    }
+    indices.swap(output);
+}
+
+// renumbers vertices in order of first use so the vertex fetch walks memory sequentially
+inline void optimizeVertexFetch(Mesh& mesh)
+{
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(mesh.vertexCount(), unused);
+    std::vector<float> vertices;
+    vertices.reserve(mesh.vertices.size());
+    unsigned int next = 0;
+    for (size_t i = 0; i < mesh.indices.size(); i++) {
+        unsigned int& index = mesh.indices[i];
+        if (remap[index] == unused) {
+            remap[index] = next++;
+            const float* vertex = &mesh.vertices[index * mesh.floatsPerVertex];
+            vertices.insert(vertices.end(), vertex, vertex + mesh.floatsPerVertex);
+        }
+        index = remap[index];
+    }
+    // vertices no triangle references are dropped
+    mesh.vertices.swap(vertices);
+}
+
+// weld + vertex cache + vertex fetch optimisation of a non-indexed triangle list.
+// `before` describes drawing the input with glDrawArrays, `after` the returned index buffer.
+inline Mesh buildOptimizedMesh(const float* vertices, size_t vertexCount, unsigned int floatsPerVertex, VertexCacheStats* before = NULL, VertexCacheStats* after = NULL)
+{
+    if (before != NULL) {
+        // unindexed: every corner is its own vertex and nothing is reused
+        before->acmr = 3.0;
+        before->atvr = 1.0;
+    }
+    Mesh mesh = weldVertices(vertices, vertexCount, floatsPerVertex);
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    optimizeVertexFetch(mesh);
+    if (after != NULL) {
+        *after = analyzeVertexCache(mesh.indices, mesh.vertexCount());
+    }
+    return mesh;
+}
+
+// sphere (center, radius) around the mesh's positions, the first 3 floats of every vertex
+inline glm::vec4 boundingSphere(const Mesh& mesh)
+{
+    if (mesh.vertexCount() == 0) {
+        return glm::vec4(0.0f);
+    }
+    glm::vec3 low(mesh.vertices[0], mesh.vertices[1], mesh.vertices[2]);
+    glm::vec3 high = low;
+    for (size_t v = 0; v < mesh.vertexCount(); v++) {
+        const float* position = &mesh.vertices[v * mesh.floatsPerVertex];
+        low = glm::min(low, glm::vec3(position[0], position[1], position[2]));
+        high = glm::max(high, glm::vec3(position[0], position[1], position[2]));
+    }
+    glm::vec3 center = (low + high) * 0.5f;
+    float radius = 0.0f;
+    for (size_t v = 0; v < mesh.vertexCount(); v++) {
+        const float* position = &mesh.vertices[v * mesh.floatsPerVertex];
+        radius = std::max(radius, glm::length(glm::vec3(position[0], position[1], position[2]) - center));
+    }
+    return glm::vec4(center, radius);
+}
+
+// One storage buffer with the packed vertices of every MeshBuffer in vertex-pulling mode, bound at
+// VERTEX_PULL_BINDING for good, and one with a PulledMesh record per mesh at VERTEX_PULL_MESHES_BINDING.
+// Meshes are appended, each at a whole multiple of its stride, so its vertices are numbered from the
+// start of the pool and its indices count from there; the buffers are freed when the last mesh is
+// destroyed.
+class VertexPullPool
+{
+public:
+    // the index of a mesh's record lives in 16 bits of its positions' padding
+    static const size_t MAX_MESHES = 65536;
+
+    // whether vertex shaders can read the two storage buffers, GL 4.3 allows none
+    static bool supported()
+    {
+        GLint blocks = 0, bindings = 0;
+        glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &blocks);
+        glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &bindings);
+        return blocks >= 2 && bindings > (GLint)VERTEX_PULL_MESHES_BINDING;
+    }
+
+    // Copies packed vertices in, with the index of the mesh's record in each position's padding, and
+    // returns the pool vertex they start at. A float position has no padding and nothing to decode,
+    // so its layout must not need the record either (see MeshBuffer::upload).
+    unsigned int add(std::vector<unsigned char> bytes, const VertexLayout& layout)
+    {
+        if (layout.format.position != POSITION_FLOAT) {
+            unsigned short record = (unsigned short)records.size();
+            for (size_t v = 0; v < bytes.size(); v += layout.stride) {
+                // after x, y, z: the fourth 16 bit component
+                std::memcpy(&bytes[v + 6], &record, sizeof(record));
+            }
+        }
+        records.push_back(layout.pulledMesh());
+        if (recordBuffer == 0) {
+            glGenBuffers(1, &recordBuffer);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, recordBuffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, records.size() * sizeof(PulledMesh), records.data(), GL_STATIC_DRAW);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VERTEX_PULL_MESHES_BINDING, recordBuffer);
+
+        size_t offset = (used + layout.stride - 1) / layout.stride * layout.stride;
+        if (offset + bytes.size() > capacity) {
+            size_t newCapacity = std::max(std::max(capacity * 2, offset + bytes.size()), (size_t)64 * 1024);
+            unsigned int newBuffer;
+            glGenBuffers(1, &newBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, NULL, GL_STATIC_DRAW);
+            if (buffer != 0) {
+                glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+                glDeleteBuffers(1, &buffer);
+            }
+            buffer = newBuffer;
+            capacity = newCapacity;
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes.size(), bytes.data());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VERTEX_PULL_BINDING, buffer);
+        used = offset + bytes.size();
+        meshes++;
+        return (unsigned int)(offset / layout.stride);
+    }
+
+    // whether add() can take another mesh
+    bool full() const { return records.size() >= MAX_MESHES; }
+
+    void release()
+    {
+        if (meshes > 0 && --meshes == 0) {
+            unsigned int buffers[] = { buffer, recordBuffer };
+            glDeleteBuffers(2, buffers);
+            buffer = recordBuffer = 0;
+            used = capacity = 0;
+            records.clear();
+        }
+    }
+
+    size_t size() const { return used; }
+    size_t meshCount() const { return meshes; }
+
+private:
+    unsigned int buffer = 0;
+    unsigned int recordBuffer = 0;
+    std::vector<PulledMesh> records;
+    size_t used = 0;
+    size_t capacity = 0;
+    unsigned int meshes = 0;
+};
+
+inline VertexPullPool& vertexPullPool()
+{
+    static VertexPullPool pool;
+    return pool;
+}
+
+// the allocator every MeshBuffer takes its vertex and index ranges from
+inline BufferAllocator& meshBuffers()
+{
+    static BufferAllocator allocator;
+    return allocator;
+}
+
+// A mesh on the GPU. Its vertices and indices are ranges of the shared meshBuffers(), so any number of
+// meshes costs a handful of buffer objects, and VAOs read the vertices as attributes. With
+// setVertexPulling(true) the vertices go into the shared VertexPullPool instead, the vertex shader
+// fetches them by gl_VertexID (see shaderDecode) and every createVertexArray() returns the same
+// attribute-less VAO holding just the index buffer, so switching between a mesh's passes (the lit cube
+// and the light cube) doesn't switch VAOs. The indices then count from the start of the pool and the
+// decode depends only on the vertex format, so meshes that batchWith() each other go out in one
+// (multi-)draw with one program.
+//
+// Draws pass indexOffset() (or firstIndex() for indirect draws) as the start of the indices.
+// meshBuffers().defragment() may move both; refreshAll() then points every uploaded mesh's VAOs at the
+// new ranges, and anyone who kept a firstIndex() takes it again when meshBuffers().generation() changes.
+class MeshBuffer
+{
+public:
+    MeshBuffer() = default;
+    // uploaded meshes are tracked by address for refreshAll()
+    MeshBuffer(const MeshBuffer&) = delete;
+    MeshBuffer& operator=(const MeshBuffer&) = delete;
+
+    ~MeshBuffer()
+    {
+        untrack();
+    }
+
+    // refresh() on every uploaded mesh, after meshBuffers().defragment()
+    static void refreshAll()
+    {
+        for (size_t i = 0; i < uploaded().size(); i++) {
+            uploaded()[i]->refresh();
+        }
+    }
+
+    // applies to meshes uploaded afterwards; ignored where vertex shaders can't read storage buffers
+    static void setVertexPulling(bool enabled)
+    {
+        pullingRequested() = enabled;
+    }
+
+    void upload(const Mesh& mesh, const VertexFormat& format = VertexFormat())
+    {
+        count = (GLsizei)mesh.indices.size();
+        bool pull = pullingRequested() && VertexPullPool::supported() && !vertexPullPool().full();
+        VertexFormat packedFormat = format;
+        if (pull && format.position == POSITION_FLOAT) {
+            // no position padding to find the mesh's record through, so nothing may need one
+            packedFormat.texCoord = TEXCOORD_FLOAT;
+        }
+        std::vector<unsigned char> packed = packVertices(mesh.vertices.data(), mesh.vertexCount(), mesh.floatsPerVertex, packedFormat, layout);
+
+        if (pull) {
+            firstVertex = (int)vertexPullPool().add(packed, layout);
+        } else {
+            vertices = meshBuffers().allocate(packed.size(), packed.data());
+        }
+
+        // 16-bit indices halve the index fetch whenever the mesh (and, pulled, where it sits in the
+        // pool) is small enough
+        std::vector<unsigned int> shifted(mesh.indices);
+        for (size_t i = 0; i < shifted.size(); i++) {
+            shifted[i] += vertexBase();
+        }
+        if (vertexBase() + mesh.vertexCount() <= 65536) {
+            std::vector<unsigned short> shortIndices(shifted.begin(), shifted.end());
+            indices = meshBuffers().allocate(shortIndices.size() * sizeof(unsigned short), shortIndices.data());
+            type = GL_UNSIGNED_SHORT;
+        } else {
+            indices = meshBuffers().allocate(shifted.size() * sizeof(unsigned int), shifted.data());
+            type = GL_UNSIGNED_INT;
+        }
+        generation = meshBuffers().generation();
+        if (std::find(uploaded().begin(), uploaded().end(), this) == uploaded().end()) {
+            uploaded().push_back(this);
+        }
+    }
+
+    // VAO whose attribute locations 0, 1, ... read the requested attributes in position, normal, uv order:
+    // VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD    VERTEX_POSITION | VERTEX_TEXCOORD    VERTEX_POSITION
+    unsigned int createVertexArray(unsigned int attributes)
+    {
+        if (pulling()) {
+            // destroy() deletes it unless the caller already has
+            if (pullingVAO == 0) {
+                glGenVertexArrays(1, &pullingVAO);
+                vertexArrays.push_back(std::make_pair(pullingVAO, 0u));
+                setUp(pullingVAO, 0);
+            }
+            return pullingVAO;
+        }
+        return createUnsharedVertexArray(attributes);
+    }
+
+    // createVertexArray, but a VAO of its own even with vertex pulling, for callers that enable
+    // attributes of their own on it (e.g. VertexLightBaker::attach) and mustn't change everyone's
+    unsigned int createUnsharedVertexArray(unsigned int attributes)
+    {
+        unsigned int VAO;
+        glGenVertexArrays(1, &VAO);
+        vertexArrays.push_back(std::make_pair(VAO, attributes));
+        setUp(VAO, attributes);
+        return VAO;
+    }
+
+    // VAO reading only location 0, the position, from a stream that holds nothing else: a depth prepass
+    // fetches a third of the bytes. Positions decode to exactly what createVertexArray's do. The stream
+    // is built on the first call, so meshes never drawn depth-only don't carry it.
+    unsigned int createPositionArray()
+    {
+        if (pulling()) {
+            return createVertexArray(VERTEX_POSITION);
+        }
+        if (positions == 0) {
+            uploadPositions();
+        }
+        unsigned int VAO;
+        glGenVertexArrays(1, &VAO);
+        vertexArrays.push_back(std::make_pair(VAO, (unsigned int)POSITION_STREAM));
+        setUp(VAO, POSITION_STREAM);
+        return VAO;
+    }
+
+    // after meshBuffers().defragment() has moved this mesh, points its VAOs at the new ranges
+    void refresh()
+    {
+        if (generation == meshBuffers().generation()) {
+            return;
+        }
+        for (size_t i = 0; i < vertexArrays.size(); i++) {
+            // the caller may have deleted it
+            if (glIsVertexArray(vertexArrays[i].first)) {
+                setUp(vertexArrays[i].first, vertexArrays[i].second);
+            }
+        }
+        generation = meshBuffers().generation();
+    }
+
+    // decode functions for vertex shaders reading this buffer, pass to Application::loadShader
+    std::string shaderDecode() const { return layout.shaderDecode(pulling()); }
+    bool pulling() const { return firstVertex >= 0; }
+    // the vertex the indices count from: 0, or pulled, where the mesh starts in the pool. Streams of
+    // its own indexed like its vertices (lightmap uvs, baked colours) start there too.
+    unsigned int vertexBase() const { return pulling() ? (unsigned int)firstVertex : 0; }
+
+    // true when one draw can take both meshes, from either's createVertexArray() and with one program:
+    // both pulled in the same format, their indices of one type in one buffer
+    bool batchesWith(const MeshBuffer& other) const
+    {
+        return pulling() && other.pulling() && shaderDecode() == other.shaderDecode() && type == other.type
+            && meshBuffers().range(indices).buffer == meshBuffers().range(other.indices).buffer;
+    }
+    unsigned int vertexSize() const { return layout.stride; }
+    GLsizei indexCount() const { return count; }
+    GLenum indexType() const { return type; }
+
+    // where the indices start in the VAO's element buffer, in bytes and in indices
+    size_t indexOffset() const { return (size_t)meshBuffers().range(indices).offset; }
+    GLuint firstIndex() const { return (GLuint)(indexOffset() / (type == GL_UNSIGNED_SHORT ? 2 : 4)); }
+
+    void destroy()
+    {
+        meshBuffers().free(vertices);
+        meshBuffers().free(positions);
+        meshBuffers().free(indices);
+        vertices = positions = indices = 0;
+        if (pulling()) {
+            if (pullingVAO != 0 && glIsVertexArray(pullingVAO)) {
+                glDeleteVertexArrays(1, &pullingVAO);
+            }
+            pullingVAO = 0;
+            vertexPullPool().release();
+            firstVertex = -1;
+        }
+        vertexArrays.clear();
+        untrack();
+    }
+
+private:
+    // vertexArrays entry of a createPositionArray() VAO
+    static const unsigned int POSITION_STREAM = 0x80000000u;
+
+    static bool& pullingRequested()
+    {
+        static bool requested = false;
+        return requested;
+    }
+
+    static std::vector<MeshBuffer*>& uploaded()
+    {
+        static std::vector<MeshBuffer*> meshes;
+        return meshes;
+    }
+
+    void untrack()
+    {
+        std::vector<MeshBuffer*>::iterator it = std::find(uploaded().begin(), uploaded().end(), this);
+        if (it != uploaded().end()) {
+            uploaded().erase(it);
+        }
+    }
+
+    // the positions of the packed vertices, read back from their range, into a range of their own
+    void uploadPositions()
+    {
+        BufferRange range = meshBuffers().range(vertices);
+        std::vector<unsigned char> packed((size_t)range.size);
+        glBindBuffer(GL_COPY_READ_BUFFER, range.buffer);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, range.offset, range.size, packed.data());
+
+        unsigned int positionSize = layout.format.position == POSITION_FLOAT ? 12 : 8;
+        size_t vertexCount = packed.size() / layout.stride;
+        std::vector<unsigned char> packedPositions(vertexCount * positionSize);
+        for (size_t v = 0; v < vertexCount; v++) {
+            std::memcpy(&packedPositions[v * positionSize], &packed[v * layout.stride], positionSize);
+        }
+        positions = meshBuffers().allocate(packedPositions.size(), packedPositions.data());
+    }
+
+    void setUp(unsigned int VAO, unsigned int attributes) const
+    {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshBuffers().range(indices).buffer);
+        if (pulling()) {
+            return;
+        }
+        if (attributes == POSITION_STREAM) {
+            VertexLayout positionLayout = layout;
+            positionLayout.attributes = VERTEX_POSITION;
+            positionLayout.stride = layout.format.position == POSITION_FLOAT ? 12 : 8;
+            BufferRange range = meshBuffers().range(positions);
+            glBindBuffer(GL_ARRAY_BUFFER, range.buffer);
+            positionLayout.setAttributes(VERTEX_POSITION, (size_t)range.offset);
+            return;
+        }
+        BufferRange range = meshBuffers().range(vertices);
+        glBindBuffer(GL_ARRAY_BUFFER, range.buffer);
+        layout.setAttributes(attributes, (size_t)range.offset);
+    }
+
+    // meshBuffers() handles
+    unsigned int vertices = 0;
+    unsigned int positions = 0;
+    unsigned int indices = 0;
+    VertexLayout layout;
+    GLsizei count = 0;
+    GLenum type = GL_UNSIGNED_INT;
+    // where the vertices start in the VertexPullPool, -1 when they are in meshBuffers()
+    int firstVertex = -1;
+    unsigned int pullingVAO = 0;
+    // every VAO handed out and its attributes, for refresh()
+    std::vector<std::pair<unsigned int, unsigned int>> vertexArrays;
+    unsigned long long generation = 0;
+};
+
+// The unit cube every lighting demo draws: positions, normals and texture coordinates, 8 floats per
+// vertex. 36 corners weld down to 24 vertices (the faces don't share normals).
+inline const Mesh& cubeMesh(VertexCacheStats* before = NULL, VertexCacheStats* after = NULL)
+{
+    static VertexCacheStats beforeStats, afterStats;
+    static const Mesh mesh = [] {
+        const float vertices[] = {
+            // positions          // normals           // texture coords
+            -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  0.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  1.0f,  1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,  0.0f,  0.0f,
+
+            -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+            -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  1.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+            -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+            -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  1.0f,  0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,  0.0f,  1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  1.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  1.0f,  0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f,  1.0f
+        };
+        return buildOptimizedMesh(vertices, 36, 8, &beforeStats, &afterStats);
+    }();
+    if (before != NULL) {
+        *before = beforeStats;
+    }
+    if (after != NULL) {
+        *after = afterStats;
+    }
+    return mesh;
+}
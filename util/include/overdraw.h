@@ -0,0 +1,112 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <map>
+#include <string>
+
+// What a scene's opaque passes cost on the GPU, summed over the frames measured
+struct OverdrawStats {
+    bool depthPrepass = false;
+    unsigned long long frames = 0;
+    // fragments the lit pass shaded, and the pixels left visible at the end
+    unsigned long long litFragments = 0;
+    unsigned long long visiblePixels = 0;
+    double litMilliseconds = 0.0;
+    double prepassMilliseconds = 0.0;
+
+    // fragments shaded per visible pixel: 1 is no wasted shading
+    double overdraw() const
+    {
+        return visiblePixels > 0 ? (double)litFragments / visiblePixels : 0.0;
+    }
+};
+
+// per scene, for scene-runner's report
+inline std::map<std::string, OverdrawStats>& overdrawStats()
+{
+    static std::map<std::string, OverdrawStats> stats;
+    return stats;
+}
+
+// Occlusion (GL_SAMPLES_PASSED) and timer (GL_TIME_ELAPSED) queries around a scene's depth prepass,
+// lit pass and a depth-only count of the visible pixels. Results are read LATENCY frames after they
+// were issued, when the GPU has long finished them, so measuring never stalls the pipeline.
+//
+//     queries.begin(OverdrawQueries::LIT);  ...draws...  queries.end(OverdrawQueries::LIT);
+//     queries.endFrame();
+//
+// With a prepass the lit pass tests GL_EQUAL and shades the visible pixels only, so it is its own
+// VISIBLE count; without one the scene counts them by drawing its depth once more with GL_EQUAL.
+class OverdrawQueries
+{
+public:
+    static const unsigned int LATENCY = 4;
+    enum Pass { PREPASS, LIT, VISIBLE, PASS_COUNT };
+
+    void init(const std::string& scene, bool depthPrepass)
+    {
+        name = scene;
+        glGenQueries(LATENCY * PASS_COUNT, samples[0]);
+        glGenQueries(LATENCY * PASS_COUNT, time[0]);
+        overdrawStats()[name] = OverdrawStats();
+        overdrawStats()[name].depthPrepass = depthPrepass;
+    }
+
+    void begin(Pass pass)
+    {
+        glBeginQuery(GL_SAMPLES_PASSED, samples[slot][pass]);
+        glBeginQuery(GL_TIME_ELAPSED, time[slot][pass]);
+    }
+
+    void end(Pass pass)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        glEndQuery(GL_SAMPLES_PASSED);
+        issued[slot][pass] = true;
+    }
+
+    // moves on to the next frame's queries, collecting what they measured LATENCY frames ago
+    void endFrame()
+    {
+        slot = (slot + 1) % LATENCY;
+        if (!issued[slot][LIT]) {
+            return;
+        }
+        OverdrawStats& stats = overdrawStats()[name];
+        stats.frames++;
+        stats.litFragments += result(samples[slot][LIT]);
+        stats.litMilliseconds += result(time[slot][LIT]) / 1e6;
+        if (issued[slot][PREPASS]) {
+            stats.prepassMilliseconds += result(time[slot][PREPASS]) / 1e6;
+        }
+        stats.visiblePixels += result(samples[slot][issued[slot][VISIBLE] ? VISIBLE : LIT]);
+        for (unsigned int pass = 0; pass < PASS_COUNT; pass++) {
+            issued[slot][pass] = false;
+        }
+    }
+
+    void destroy()
+    {
+        if (name.empty()) {
+            return;
+        }
+        glDeleteQueries(LATENCY * PASS_COUNT, samples[0]);
+        glDeleteQueries(LATENCY * PASS_COUNT, time[0]);
+        name.clear();
+    }
+
+private:
+    static GLuint64 result(unsigned int query)
+    {
+        GLuint64 value = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &value);
+        return value;
+    }
+
+    std::string name;
+    unsigned int samples[LATENCY][PASS_COUNT] = {};
+    unsigned int time[LATENCY][PASS_COUNT] = {};
+    bool issued[LATENCY][PASS_COUNT] = {};
+    unsigned int slot = 0;
+};
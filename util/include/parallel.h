@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// threads a CPU-side job (a bake, a transform update) spreads over: one per core
+inline unsigned int workerThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// body(i) for every i in [0, count) on `threads` threads, the calling one included. Threads take
+// `grain` consecutive indices at a time off a shared counter, so uneven work still balances; the
+// order the indices run in is unspecified, so body must only write what belongs to i.
+template <typename F>
+void parallelFor(size_t count, size_t grain, unsigned int threads, const F& body)
+{
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (;;) {
+            size_t begin = next.fetch_add(grain);
+            if (begin >= count) {
+                return;
+            }
+            size_t end = std::min(count, begin + grain);
+            for (size_t i = begin; i < end; i++) {
+                body(i);
+            }
+        }
+    };
+    // not worth a thread for a single batch
+    threads = (unsigned int)std::min<size_t>(threads, (count + grain - 1) / grain);
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+}
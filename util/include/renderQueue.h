@@ -0,0 +1,200 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum RenderPass {
+    PASS_OPAQUE = 0,
+    // drawn after every opaque draw, back to front
+    PASS_TRANSPARENT = 1
+};
+
+// one submission; the queue binds program, textures and VAO, setup() sets whatever is per draw
+struct RenderItem {
+    uint64_t key;
+    unsigned int program;
+    unsigned int textureSet;
+    unsigned int vao;
+    GLenum mode;
+    GLsizei count;
+    GLenum indexType;
+    // byte offset into the VAO's element buffer
+    size_t indexOffset;
+    // the caller's own handle, e.g. an index into its object table
+    unsigned int user;
+};
+
+// Collects a frame's draws, each with a 64-bit sort key, radix-sorts them and submits them so that
+// opaque draws sharing a program, texture set and VAO run back to back:
+//
+//     bits 63-60  pass            opaque before transparent
+//     bits 59-48  program
+//     bits 47-36  texture set
+//     bits 35-24  VAO
+//     bits 23-0   depth           front to back
+//
+// Transparent draws must blend back to front across the whole pass, so their depth comes first and
+// state only groups draws at the same depth:
+//
+//     bits 63-60  pass
+//     bits 59-36  depth           back to front
+//     bits 35-24  program
+//     bits 23-12  texture set
+//     bits 11-0   VAO
+//
+// Programs and VAOs get a small id the first time they are seen, so their order is stable frame to
+// frame. State is only rebound when it differs from the previous draw's.
+//
+//     unsigned int boxes = queue.addTextureSet({ diffuseMap, specularMap });   // once
+//     queue.clear();                                                           // every frame
+//     queue.submit(PASS_OPAQUE, shader->ID, boxes, VAO, depth, GL_TRIANGLES, count, indexType, 0, i);
+//     queue.execute([&](const RenderItem& item) { /* model matrix of object item.user */ });
+class RenderQueue
+{
+public:
+    // texture set 0 binds nothing; the textures of a set go to units 0, 1, ...
+    unsigned int addTextureSet(const std::vector<unsigned int>& textures)
+    {
+        if (textureSets.empty()) {
+            textureSets.push_back(std::vector<unsigned int>());
+        }
+        textureSets.push_back(textures);
+        return (unsigned int)textureSets.size() - 1;
+    }
+
+    void clear()
+    {
+        items.clear();
+    }
+
+    // `depth` is the view-space distance to the camera; anything behind the camera sorts as 0
+    void submit(RenderPass pass, unsigned int program, unsigned int textureSet, unsigned int vao, float depth,
+        GLenum mode, GLsizei count, GLenum indexType, size_t indexOffset, unsigned int user)
+    {
+        uint64_t depthBits = quantizeDepth(depth);
+        uint64_t state = (uint64_t)(slot(programs, program) & 0xFFF) << 24
+            | (uint64_t)(textureSet & 0xFFF) << 12
+            | (uint64_t)(slot(vaos, vao) & 0xFFF);
+        RenderItem item;
+        if (pass == PASS_TRANSPARENT) {
+            item.key = (uint64_t)pass << 60 | (~depthBits & 0xFFFFFF) << 36 | state;
+        } else {
+            item.key = (uint64_t)pass << 60 | state << 24 | depthBits;
+        }
+        item.program = program;
+        item.textureSet = textureSet;
+        item.vao = vao;
+        item.mode = mode;
+        item.count = count;
+        item.indexType = indexType;
+        item.indexOffset = indexOffset;
+        item.user = user;
+        items.push_back(item);
+    }
+
+    // sorts the frame's draws and submits them, calling setup(item) right before each draw
+    template <typename Setup>
+    void execute(Setup setup)
+    {
+        sort();
+        programSwitches = textureSwitches = vaoSwitches = 0;
+        unsigned int program = 0, textureSet = 0, vao = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            const RenderItem& item = items[order[i]];
+            if (i == 0 || item.program != program) {
+                glUseProgram(item.program);
+                program = item.program;
+                programSwitches++;
+            }
+            if (item.textureSet != textureSet && item.textureSet != 0) {
+                const std::vector<unsigned int>& textures = textureSets[item.textureSet];
+                for (size_t unit = 0; unit < textures.size(); unit++) {
+                    glActiveTexture(GL_TEXTURE0 + (GLenum)unit);
+                    glBindTexture(GL_TEXTURE_2D, textures[unit]);
+                }
+                textureSet = item.textureSet;
+                textureSwitches++;
+            }
+            if (i == 0 || item.vao != vao) {
+                glBindVertexArray(item.vao);
+                vao = item.vao;
+                vaoSwitches++;
+            }
+            setup(item);
+            glDrawElements(item.mode, item.count, item.indexType, (void*)item.indexOffset);
+        }
+    }
+
+    size_t size() const { return items.size(); }
+    // state changes the last execute() made
+    unsigned int programChanges() const { return programSwitches; }
+    unsigned int textureChanges() const { return textureSwitches; }
+    unsigned int vaoChanges() const { return vaoSwitches; }
+
+private:
+    // the bit pattern of a non-negative float grows with its value; the top 24 of its 31 bits keep
+    // roughly five significant digits
+    static uint64_t quantizeDepth(float depth)
+    {
+        if (!(depth > 0.0f)) {
+            return 0;
+        }
+        uint32_t bits;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return bits >> 7;
+    }
+
+    static unsigned int slot(std::vector<unsigned int>& names, unsigned int name)
+    {
+        for (size_t i = 0; i < names.size(); i++) {
+            if (names[i] == name) {
+                return (unsigned int)i;
+            }
+        }
+        names.push_back(name);
+        return (unsigned int)names.size() - 1;
+    }
+
+    // LSD radix sort of the item indices, one byte of the key per pass; a byte every key shares
+    // (most of them, with a handful of programs and VAOs) is skipped
+    void sort()
+    {
+        order.resize(items.size());
+        scratch.resize(items.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = (unsigned int)i;
+        }
+        for (unsigned int shift = 0; shift < 64; shift += 8) {
+            size_t counts[256] = {};
+            for (size_t i = 0; i < items.size(); i++) {
+                counts[(items[i].key >> shift) & 0xFF]++;
+            }
+            if (items.empty() || counts[(items[0].key >> shift) & 0xFF] == items.size()) {
+                continue;
+            }
+            size_t offsets[256];
+            size_t total = 0;
+            for (unsigned int digit = 0; digit < 256; digit++) {
+                offsets[digit] = total;
+                total += counts[digit];
+            }
+            for (size_t i = 0; i < order.size(); i++) {
+                scratch[offsets[(items[order[i]].key >> shift) & 0xFF]++] = order[i];
+            }
+            order.swap(scratch);
+        }
+    }
+
+    std::vector<RenderItem> items;
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> scratch;
+    std::vector<std::vector<unsigned int>> textureSets;
+    std::vector<unsigned int> programs;
+    std::vector<unsigned int> vaos;
+    unsigned int programSwitches = 0;
+    unsigned int textureSwitches = 0;
+    unsigned int vaoSwitches = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <shader.h>
+#include <texture.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+// Compiles each shader program and uploads each texture once per GL context.
+// Scenes sharing a context share one cache, so switching between them doesn't reload anything.
+class ResourceCache
+{
+public:
+    // the returned shader lives until clear(); see Shader for vertexHeader
+    Shader* shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& vertexHeader = std::string())
+    {
+        std::string key = vertexPath + "|" + fragmentPath + "|" + vertexHeader;
+        std::map<std::string, std::unique_ptr<Shader>>::iterator it = shaders.find(key);
+        if (it != shaders.end()) {
+            hits++;
+            return it->second.get();
+        }
+        misses++;
+        Shader* program = new Shader(vertexPath.c_str(), fragmentPath.c_str(), vertexHeader);
+        shaders[key] = std::unique_ptr<Shader>(program);
+        return program;
+    }
+
+    unsigned int texture(const std::string& filename, bool flipVertically = false)
+    {
+        std::string key = filename + (flipVertically ? "|flipped" : "");
+        std::map<std::string, unsigned int>::iterator it = textures.find(key);
+        if (it != textures.end()) {
+            hits++;
+            return it->second;
+        }
+        misses++;
+        stbi_set_flip_vertically_on_load(flipVertically);
+        unsigned int id = textureHelper.generateTexture(filename);
+        stbi_set_flip_vertically_on_load(false);
+        textures[key] = id;
+        return id;
+    }
+
+    // deletes every cached program and texture; the context must be current
+    void clear()
+    {
+        for (std::map<std::string, std::unique_ptr<Shader>>::iterator it = shaders.begin(); it != shaders.end(); ++it) {
+            glDeleteProgram(it->second->ID);
+        }
+        for (std::map<std::string, unsigned int>::iterator it = textures.begin(); it != textures.end(); ++it) {
+            glDeleteTextures(1, &it->second);
+        }
+        shaders.clear();
+        textures.clear();
+    }
+
+    size_t shaderCount() const { return shaders.size(); }
+    size_t textureCount() const { return textures.size(); }
+    // lookups served from the cache / lookups that had to load from disk
+    unsigned long long hitCount() const { return hits; }
+    unsigned long long missCount() const { return misses; }
+
+private:
+    Texture textureHelper;
+    std::map<std::string, std::unique_ptr<Shader>> shaders;
+    std::map<std::string, unsigned int> textures;
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glExtensions.h>
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// one sub-allocation of a RingBuffer, valid until the end of the frame it was made in
+struct RingAllocation {
+    // NULL unless the ring is persistently mapped
+    void* data = NULL;
+    unsigned int buffer = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+};
+
+// Streams per-frame data (uniform blocks, storage blocks, instance attributes) to the GPU without
+// driver-side copies. One buffer, created with glBufferStorage and mapped once, persistent and
+// coherent, is split into FRAMES regions; the CPU writes frame N's data into region N % FRAMES
+// while the GPU may still be reading the two before it. A fence at the end of every frame keeps
+// the CPU from overwriting a region the GPU hasn't finished with.
+//
+//     RingAllocation lights = frameData->upload(&block, sizeof(block), frameData->uniformAlignment());
+//     RingBuffer::bindUniform(0, lights);
+//
+// Application calls beginFrame() / endFrame() around every frame. Without GL 4.4 or
+// GL_ARB_buffer_storage the same regions and fences are used, but upload() goes through glBufferSubData.
+class RingBuffer
+{
+public:
+    static const unsigned int FRAMES = 3;
+
+    // whether allocate() hands out writable pointers
+    bool persistent() const
+    {
+        return glExtensions().bufferStorage != NULL;
+    }
+
+    // waits, if necessary, until the GPU is done with the region this frame reuses
+    void beginFrame()
+    {
+        unsigned int region = (unsigned int)(frame % FRAMES);
+        if (fences[region] != 0) {
+            GLenum result = glClientWaitSync(fences[region], 0, 0);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                stalls++;
+                while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {
+                }
+            }
+            glDeleteSync(fences[region]);
+            fences[region] = 0;
+        }
+        head = region * regionSize;
+        used = 0;
+    }
+
+    void endFrame()
+    {
+        unsigned int region = (unsigned int)(frame % FRAMES);
+        if (buffer != 0) {
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        lastFrameBytes = used;
+        frame++;
+        releaseRetired();
+    }
+
+    // Reserves `bytes` of this frame's region; `alignment` must be a power of two. The regions double
+    // when a frame needs more than they hold.
+    RingAllocation allocate(size_t bytes, size_t alignment = 16)
+    {
+        size_t region = frame % FRAMES;
+        size_t start = (head + alignment - 1) & ~(alignment - 1);
+        if (buffer == 0 || start + bytes > (region + 1) * regionSize) {
+            grow(bytes + alignment);
+            start = (head + alignment - 1) & ~(alignment - 1);
+        }
+        RingAllocation allocation;
+        allocation.data = mapped != NULL ? mapped + start : NULL;
+        allocation.buffer = buffer;
+        allocation.offset = (GLintptr)start;
+        allocation.size = (GLsizeiptr)bytes;
+        used += start + bytes - head;
+        head = start + bytes;
+        return allocation;
+    }
+
+    // allocate() and copy `data` in
+    RingAllocation upload(const void* data, size_t bytes, size_t alignment = 16)
+    {
+        RingAllocation allocation = allocate(bytes, alignment);
+        if (allocation.data != NULL) {
+            std::memcpy(allocation.data, data, bytes);
+        } else {
+            glBindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, allocation.offset, bytes, data);
+        }
+        return allocation;
+    }
+
+    // offset alignments glBindBufferRange needs for uniform / storage blocks
+    size_t uniformAlignment()
+    {
+        return alignment(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, uniformOffsetAlignment);
+    }
+
+    size_t storageAlignment()
+    {
+        return alignment(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, storageOffsetAlignment);
+    }
+
+    static void bindUniform(GLuint index, const RingAllocation& allocation)
+    {
+        glBindBufferRange(GL_UNIFORM_BUFFER, index, allocation.buffer, allocation.offset, allocation.size);
+    }
+
+    static void bindStorage(GLuint index, const RingAllocation& allocation)
+    {
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, index, allocation.buffer, allocation.offset, allocation.size);
+    }
+
+    // frames finished so far; an allocation made in an earlier frame must not be used any more
+    unsigned long long frameNumber() const { return frame; }
+    size_t frameCapacity() const { return regionSize; }
+    size_t lastFrameUsage() const { return lastFrameBytes; }
+    // frames that had to wait for the GPU, a sign FRAMES is too small for the GPU's latency
+    unsigned long long stallCount() const { return stalls; }
+
+    void destroy()
+    {
+        for (unsigned int i = 0; i < FRAMES; i++) {
+            if (fences[i] != 0) {
+                glDeleteSync(fences[i]);
+                fences[i] = 0;
+            }
+        }
+        if (buffer != 0) {
+            retire();
+        }
+        releaseRetired();
+        regionSize = INITIAL_REGION_SIZE;
+        head = used = 0;
+    }
+
+private:
+    static const size_t INITIAL_REGION_SIZE = 256 * 1024;
+
+    static size_t alignment(GLenum query, GLint& cached)
+    {
+        if (cached == 0) {
+            glGetIntegerv(query, &cached);
+        }
+        return cached > 16 ? (size_t)cached : 16;
+    }
+
+    // Replaces the buffer with a larger one. The old one stays mapped until the end of the frame for
+    // allocations already handed out, and draws already submitted keep it alive after that (GL defers
+    // deleting a buffer that is in use), so nothing has to wait.
+    void grow(size_t minimumRegion)
+    {
+        size_t newSize = buffer == 0 ? regionSize : regionSize * 2;
+        while (newSize < minimumRegion) {
+            newSize *= 2;
+        }
+        if (buffer != 0) {
+            retire();
+            for (unsigned int i = 0; i < FRAMES; i++) {
+                if (fences[i] != 0) {
+                    glDeleteSync(fences[i]);
+                    fences[i] = 0;
+                }
+            }
+        }
+        regionSize = newSize;
+
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (persistent()) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glExtensions().bufferStorage(GL_ARRAY_BUFFER, regionSize * FRAMES, NULL, flags);
+            mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, regionSize * FRAMES, flags);
+            if (mapped == NULL) {
+                std::cout << "ERROR::RING_BUFFER:: Failed to map the ring buffer" << std::endl;
+            }
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, regionSize * FRAMES, NULL, GL_DYNAMIC_DRAW);
+        }
+        head = (frame % FRAMES) * regionSize;
+    }
+
+    void retire()
+    {
+        retired.push_back(std::make_pair(buffer, mapped != NULL));
+        buffer = 0;
+        mapped = NULL;
+    }
+
+    void releaseRetired()
+    {
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].second) {
+                glBindBuffer(GL_ARRAY_BUFFER, retired[i].first);
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+            }
+            glDeleteBuffers(1, &retired[i].first);
+        }
+        retired.clear();
+    }
+
+    unsigned int buffer = 0;
+    unsigned char* mapped = NULL;
+    // replaced buffers and whether they are mapped, deleted at the end of the frame
+    std::vector<std::pair<unsigned int, bool>> retired;
+    GLsync fences[FRAMES] = {};
+    size_t regionSize = INITIAL_REGION_SIZE;
+    size_t head = 0;
+    size_t used = 0;
+    size_t lastFrameBytes = 0;
+    unsigned long long frame = 0;
+    unsigned long long stalls = 0;
+    GLint uniformOffsetAlignment = 0;
+    GLint storageOffsetAlignment = 0;
+};
@@ -12,9 +12,10 @@ class Shader
 {
 public:
     unsigned int ID;
-    // constructor generates the shader on the fly
+    // constructor generates the shader on the fly; vertexHeader (e.g. generated decode functions)
+    // is inserted right after the vertex shader's #version line
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string& vertexHeader = std::string())
     {
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -44,6 +45,12 @@ public:
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
         }
+        if (!vertexHeader.empty())
+        {
+            size_t versionEnd = vertexCode.compare(0, 8, "#version") == 0 ? vertexCode.find('\n') : std::string::npos;
+            size_t insertAt = versionEnd == std::string::npos ? 0 : versionEnd + 1;
+            vertexCode.insert(insertAt, vertexHeader);
+        }
         const char* vShaderCode = vertexCode.c_str();
         const char* fShaderCode = fragmentCode.c_str();
         // 2. compile shaders
@@ -118,4 +125,31 @@ private:
         }
     }
 };
+
+// compiles and links a compute shader from source (the classes that dispatch one generate theirs);
+// errors are printed like Shader's
+inline unsigned int compileComputeProgram(const std::string& source)
+{
+    const char* code = source.c_str();
+    unsigned int shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &code, NULL);
+    glCompileShader(shader);
+    int success;
+    char infoLog[1024];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: COMPUTE\n" << infoLog << std::endl;
+    }
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, shader);
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(program, 1024, NULL, infoLog);
+        std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: COMPUTE\n" << infoLog << std::endl;
+    }
+    glDeleteShader(shader);
+    return program;
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <frustum.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// texture units the lit shaders find the shadow maps on
+const unsigned int CASCADE_SHADOW_UNIT = 4;
+const unsigned int POINT_SHADOW_UNIT = 5;
+
+// Shadow map renders, summed over the frames run, for scene-runner's report
+struct ShadowStats {
+    // layers (cascades, cube faces) that existed, frame by frame
+    unsigned long long layerFrames = 0;
+    // of those, redrawn with the static casters, and redrawn with the moving ones
+    unsigned long long staticRenders = 0;
+    unsigned long long dynamicRenders = 0;
+};
+
+inline ShadowStats& shadowStats()
+{
+    static ShadowStats stats;
+    return stats;
+}
+
+// Depth layers (the cascades of a directional light, the faces of a point light's cube) with the static
+// casters' depth cached. Every layer has two depth images: the cache holds the static casters only
+// and is redrawn when the layer's matrix changes; the map the shaders sample is the cache plus the
+// moving casters, and is only copied from the cache and drawn over when a moving caster's sphere
+// reaches into the layer. A still camera and light cost nothing for layers nothing moves through.
+//
+//     shadows.fit(...);                                  // derived classes: places the layers
+//     for (...) shadows.addMovingCaster(transformSphere(model, bounds));
+//     for (unsigned int layer = 0; layer < shadows.layerCount(); layer++) {
+//         if (shadows.beginStatic(layer)) { ...static casters with layerMatrix(layer)... }
+//         if (shadows.beginDynamic(layer)) { ...moving casters with layerMatrix(layer)... }
+//     }
+//     shadows.end();                                     // restores the framebuffer, binds the maps
+class ShadowMapSet
+{
+public:
+    void addMovingCaster(const glm::vec4& sphere)
+    {
+        movingCasters.push_back(sphere);
+    }
+
+    // whether `layer`'s static depth has to be redrawn; if so the cache layer is bound and cleared
+    bool beginStatic(unsigned int layer)
+    {
+        if (layers[layer].cached) {
+            return false;
+        }
+        bindLayer(cache, layer);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        layers[layer].cached = true;
+        layers[layer].mapIsCache = false;
+        shadowStats().staticRenders++;
+        return true;
+    }
+
+    // whether moving casters reach into `layer`; if so its map is bound, already holding the static
+    // depth. Call after beginStatic for the layer.
+    bool beginDynamic(unsigned int layer)
+    {
+        glm::vec4 planes[6];
+        frustumPlanes(layers[layer].matrix, planes);
+        bool touched = false;
+        for (size_t i = 0; i < movingCasters.size() && !touched; i++) {
+            touched = sphereInFrustum(planes, movingCasters[i]);
+        }
+        if (touched || !layers[layer].mapIsCache) {
+            glCopyImageSubData(cache, target, 0, 0, 0, layer, map, target, 0, 0, 0, layer, size, size, 1);
+            layers[layer].mapIsCache = !touched;
+        }
+        if (!touched) {
+            return false;
+        }
+        bindLayer(map, layer);
+        shadowStats().dynamicRenders++;
+        return true;
+    }
+
+    // back to the framebuffer and viewport of before the first begin, with the maps on their unit
+    void end()
+    {
+        if (bound) {
+            glDisable(GL_POLYGON_OFFSET_FILL);
+            glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+            glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+            bound = false;
+        }
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, map);
+        glActiveTexture(GL_TEXTURE0);
+        movingCasters.clear();
+        shadowStats().layerFrames += layers.size();
+    }
+
+    unsigned int layerCount() const { return (unsigned int)layers.size(); }
+    const glm::mat4& layerMatrix(unsigned int layer) const { return layers[layer].matrix; }
+
+    void destroy()
+    {
+        if (framebuffer == 0) {
+            return;
+        }
+        unsigned int textures[] = { cache, map };
+        glDeleteTextures(2, textures);
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = cache = map = 0;
+        layers.clear();
+    }
+
+protected:
+    // `layerTarget` GL_TEXTURE_2D_ARRAY or GL_TEXTURE_CUBE_MAP, `layerSize` square texels a layer
+    void create(GLenum layerTarget, unsigned int count, unsigned int layerSize, unsigned int textureUnit)
+    {
+        target = layerTarget;
+        size = layerSize;
+        unit = textureUnit;
+        layers.assign(count, Layer());
+        cache = createTexture(count);
+        map = createTexture(count);
+        GLint previous = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        attach(cache, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::SHADOW_MAPS:: Framebuffer is not complete" << std::endl;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, previous);
+    }
+
+    // a layer whose matrix changes loses its cached static depth
+    void setLayerMatrix(unsigned int layer, const glm::mat4& matrix)
+    {
+        if (matrix != layers[layer].matrix) {
+            layers[layer].matrix = matrix;
+            layers[layer].cached = false;
+        }
+    }
+
+private:
+    struct Layer {
+        glm::mat4 matrix = glm::mat4(0.0f);
+        bool cached = false;
+        // the map layer holds the static depth only, as the cache does
+        bool mapIsCache = false;
+    };
+
+    unsigned int createTexture(unsigned int count) const
+    {
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(target, texture);
+        if (target == GL_TEXTURE_CUBE_MAP) {
+            for (unsigned int face = 0; face < 6; face++) {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+            }
+        } else {
+            glTexImage3D(target, 0, GL_DEPTH_COMPONENT24, size, size, count, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+        }
+        // sampled with sampler2DArrayShadow / samplerCubeShadow, bilinear filtered comparisons
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(target, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        return texture;
+    }
+
+    void attach(unsigned int texture, unsigned int layer)
+    {
+        if (target == GL_TEXTURE_CUBE_MAP) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer, texture, 0);
+        } else {
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, layer);
+        }
+    }
+
+    void bindLayer(unsigned int texture, unsigned int layer)
+    {
+        if (!bound) {
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+            glGetIntegerv(GL_VIEWPORT, previousViewport);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glViewport(0, 0, size, size);
+            // slope-scaled, against acne on surfaces at a grazing angle to the light
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(2.0f, 4.0f);
+            bound = true;
+        }
+        attach(texture, layer);
+    }
+
+    GLenum target = GL_TEXTURE_2D_ARRAY;
+    unsigned int size = 0;
+    unsigned int unit = 0;
+    unsigned int cache = 0;
+    unsigned int map = 0;
+    unsigned int framebuffer = 0;
+    std::vector<Layer> layers;
+    std::vector<glm::vec4> movingCasters;
+    bool bound = false;
+    GLint previousFramebuffer = 0;
+    GLint previousViewport[4] = {};
+};
+
+// Cascaded shadow maps of a directional light. The camera's frustum, up to `distance`, is cut into
+// CASCADES slices (a blend of logarithmic and uniform splits), and each slice gets an orthographic
+// light view around its bounding sphere. The sphere's radius is rounded and its center snapped to
+// whole texels, so the matrices - and with them the cached static depth - stay put while the camera
+// does, and shadow edges don't shimmer when it moves. Sampled as a sampler2DArrayShadow on
+// CASCADE_SHADOW_UNIT; see light-caster-directional/shader.fs for the lookup.
+class CascadedShadowMaps : public ShadowMapSet
+{
+public:
+    static const unsigned int CASCADES = 4;
+    static const unsigned int SIZE = 1024;
+
+    void init()
+    {
+        create(GL_TEXTURE_2D_ARRAY, CASCADES, SIZE, CASCADE_SHADOW_UNIT);
+    }
+
+    // `direction` is the way the light travels; casters up to `casterReach` units in front of a
+    // cascade, towards the light, still shadow it
+    void fit(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& direction, float distance = 40.0f,
+        float casterReach = 40.0f)
+    {
+        float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+        float tanX = 1.0f / projection[0][0];
+        float tanY = 1.0f / projection[1][1];
+        glm::mat4 cameraToWorld = glm::inverse(view);
+        glm::vec3 lightDirection = glm::normalize(direction);
+        glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+
+        float sliceNear = nearPlane;
+        for (unsigned int c = 0; c < CASCADES; c++) {
+            float t = (float)(c + 1) / CASCADES;
+            float sliceFar = 0.75f * nearPlane * std::pow(distance / nearPlane, t) + 0.25f * (nearPlane + (distance - nearPlane) * t);
+            splits[c] = sliceFar;
+
+            // the slice's bounding sphere in world space
+            glm::vec3 corners[8];
+            glm::vec3 center(0.0f);
+            for (unsigned int i = 0; i < 8; i++) {
+                float depth = (i & 4) != 0 ? sliceFar : sliceNear;
+                glm::vec3 corner((i & 1) != 0 ? depth * tanX : -depth * tanX, (i & 2) != 0 ? depth * tanY : -depth * tanY, -depth);
+                corners[i] = glm::vec3(cameraToWorld * glm::vec4(corner, 1.0f));
+                center += corners[i] / 8.0f;
+            }
+            float radius = 0.0f;
+            for (unsigned int i = 0; i < 8; i++) {
+                radius = std::max(radius, glm::length(corners[i] - center));
+            }
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+
+            float texel = 2.0f * radius / SIZE;
+            glm::vec3 lightCenter = glm::floor(glm::vec3(lightView * glm::vec4(center, 1.0f)) / texel) * texel;
+            glm::mat4 lightProjection = glm::ortho(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius,
+                -lightCenter.z - radius - casterReach, -lightCenter.z + radius);
+            setLayerMatrix(c, lightProjection * lightView);
+            texelSizes[c] = texel;
+            sliceNear = sliceFar;
+        }
+    }
+
+    // the lookup's uniforms: lightMatrices[CASCADES], cascadeSplits (view depth each cascade ends at),
+    // cascadeTexels (world units a texel covers) and the shadowMap sampler
+    void setUniforms(unsigned int program) const
+    {
+        glm::mat4 matrices[CASCADES];
+        for (unsigned int c = 0; c < CASCADES; c++) {
+            matrices[c] = layerMatrix(c);
+        }
+        glProgramUniformMatrix4fv(program, glGetUniformLocation(program, "lightMatrices"), CASCADES, GL_FALSE, glm::value_ptr(matrices[0]));
+        glProgramUniform4fv(program, glGetUniformLocation(program, "cascadeSplits"), 1, splits);
+        glProgramUniform4fv(program, glGetUniformLocation(program, "cascadeTexels"), 1, texelSizes);
+        glProgramUniform1i(program, glGetUniformLocation(program, "shadowMap"), CASCADE_SHADOW_UNIT);
+    }
+
+private:
+    float splits[CASCADES] = {};
+    float texelSizes[CASCADES] = {};
+};
+
+// Omnidirectional shadow of a point light: a depth cube map, one 90 degree perspective view per face,
+// out to the light's range. The faces hold ordinary perspective depth, so the casters need nothing
+// but a position-only program; the lookup turns the largest axis of the light-to-fragment vector back
+// into that depth (see light-caster-point/shader.fs). Sampled as a samplerCubeShadow on
+// POINT_SHADOW_UNIT.
+class PointShadowMap : public ShadowMapSet
+{
+public:
+    static const unsigned int SIZE = 512;
+
+    void init()
+    {
+        create(GL_TEXTURE_CUBE_MAP, 6, SIZE, POINT_SHADOW_UNIT);
+    }
+
+    void fit(const glm::vec3& position, float range)
+    {
+        // GL's cube map face order and orientations
+        static const glm::vec3 forward[6] = {
+            glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+            glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)
+        };
+        static const glm::vec3 up[6] = {
+            glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+            glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)
+        };
+        farPlane = range;
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
+        for (unsigned int face = 0; face < 6; face++) {
+            setLayerMatrix(face, projection * glm::lookAt(position, position + forward[face], up[face]));
+        }
+    }
+
+    // the lookup's uniforms: pointShadowDepth (near, far) and the pointShadowMap sampler
+    void setUniforms(unsigned int program) const
+    {
+        glProgramUniform2f(program, glGetUniformLocation(program, "pointShadowDepth"), nearPlane, farPlane);
+        glProgramUniform1i(program, glGetUniformLocation(program, "pointShadowMap"), POINT_SHADOW_UNIT);
+    }
+
+private:
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <instancedRenderer.h>
+
+#include <vector>
+
+// attribute location of the per-instance spin, past the lightmap's 11 and the baked colours' 12
+const unsigned int SPIN_LOCATION = 13;
+
+// Instances that do nothing but spin about a fixed axis at a fixed rate, animated by the vertex shader.
+// Every instance's rest transform (its model matrix at time 0) and its spin (unit axis in xyz, radians
+// per second in w) are uploaded once, to buffers of their own; a frame then sets one `time` uniform
+// and draws. No matrices are built on the CPU and nothing is uploaded per frame. The vertex shader
+// rotates before the rest transform, which is glm::rotate(rest, time * rate, axis):
+//
+//     layout (location = 13) in vec4 aSpin;
+//     uniform float time;
+//     mat3 spin = spinMatrix(aSpin.xyz, aSpin.w * time);   // see the demos' spin.vs
+//     FragPos = vec3(aModel * vec4(spin * position, 1.0));
+//     Normal = aNormalMatrix * spin * normal;
+//
+//     animation.attach(VAO);                               // once, like InstancedRenderer::attach
+//     animation.add(rest, axis, glm::radians(degreesPerSecond));
+//     glUniform1f(timeLoc, (float)renderTime());           // every frame
+//     animation.drawElements(VAO, GL_TRIANGLES, ...);
+class SpinAnimation
+{
+public:
+    // adds the rest transforms (InstancedRenderer's locations) and the spin to `vao`
+    void attach(unsigned int vao)
+    {
+        // no RingBuffer: the renderer keeps its own buffer and only uploads when the instances change
+        rest.attach(vao);
+        if (spinBuffer == 0) {
+            glGenBuffers(1, &spinBuffer);
+        }
+        glBindVertexArray(vao);
+        glVertexAttribFormat(SPIN_LOCATION, 4, GL_FLOAT, GL_FALSE, 0);
+        glVertexAttribBinding(SPIN_LOCATION, SPIN_LOCATION);
+        glEnableVertexAttribArray(SPIN_LOCATION);
+        glVertexBindingDivisor(SPIN_LOCATION, 1);
+        glBindVertexBuffer(SPIN_LOCATION, spinBuffer, 0, sizeof(glm::vec4));
+        glBindVertexArray(0);
+    }
+
+    void add(const glm::mat4& restModel, const glm::vec3& axis, float radiansPerSecond, unsigned int material = 0)
+    {
+        rest.add(restModel, material);
+        spins.push_back(glm::vec4(glm::normalize(axis), radiansPerSecond));
+        dirty = true;
+    }
+
+    void drawElements(unsigned int vao, GLenum mode, GLsizei count, GLenum type, size_t offset = 0)
+    {
+        if (dirty) {
+            glBindBuffer(GL_ARRAY_BUFFER, spinBuffer);
+            glBufferData(GL_ARRAY_BUFFER, spins.size() * sizeof(glm::vec4), spins.data(), GL_STATIC_DRAW);
+            dirty = false;
+        }
+        rest.drawElements(vao, mode, count, type, offset);
+    }
+
+    size_t size() const { return spins.size(); }
+
+    void destroy()
+    {
+        rest.destroy();
+        glDeleteBuffers(1, &spinBuffer);
+        spinBuffer = 0;
+        spins.clear();
+        dirty = true;
+    }
+
+private:
+    InstancedRenderer rest;
+    std::vector<glm::vec4> spins;
+    unsigned int spinBuffer = 0;
+    bool dirty = true;
+};
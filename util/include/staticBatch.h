@@ -0,0 +1,207 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <frustum.h>
+#include <instancedRenderer.h>
+#include <mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Merges geometry that never moves into one mesh at load time. Every object is transformed into world
+// space on the CPU, and the result is ordered by material and, within a material, by the cube of
+// chunkSize world units the object's center falls in. A chunk is one contiguous index range with its
+// own bounding sphere, so draw() can still skip chunks outside the view; visible neighbours go out as
+// a single draw. A static scene of N objects costs a handful of draws instead of N.
+//
+//     batch.add(cubeMesh(), model, material);           // every static object, at load time
+//     batch.build();
+//     shader = loadShader(vs, fs, batch.shaderDecode());
+//     VAO = batch.createVertexArray(VERTEX_POSITION | VERTEX_NORMAL | VERTEX_TEXCOORD);
+//     batch.draw(VAO, material, projection * view);       // every frame, per material
+//
+// The VAO has no instance arrays; draw() sets the instance attributes to an identity transform (see
+// InstancedRenderer::setConstantInstance), so instanced shaders draw batches unchanged. Objects that
+// move stay on the instanced path.
+class StaticBatch
+{
+public:
+    static constexpr float DEFAULT_CHUNK_SIZE = 16.0f;
+
+    // all meshes of a batch must have the same vertex layout (floatsPerVertex)
+    void add(const Mesh& mesh, const glm::mat4& model, unsigned int material = 0)
+    {
+        if (floatsPerVertex == 0) {
+            floatsPerVertex = mesh.floatsPerVertex;
+        }
+        if (mesh.floatsPerVertex != floatsPerVertex) {
+            std::cout << "ERROR::STATIC_BATCH:: Mesh with " << mesh.floatsPerVertex << " floats per vertex added to a batch of "
+                << floatsPerVertex << std::endl;
+            return;
+        }
+        bool hasNormal = floatsPerVertex == 6 || floatsPerVertex == 8;
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+
+        Object object;
+        object.material = material;
+        object.vertices = mesh.vertices;
+        object.indices = mesh.indices;
+        glm::vec3 low(0.0f), high(0.0f);
+        for (size_t v = 0; v < mesh.vertexCount(); v++) {
+            float* vertex = &object.vertices[v * floatsPerVertex];
+            glm::vec3 position = glm::vec3(model * glm::vec4(vertex[0], vertex[1], vertex[2], 1.0f));
+            vertex[0] = position.x;
+            vertex[1] = position.y;
+            vertex[2] = position.z;
+            if (hasNormal) {
+                glm::vec3 normal = glm::normalize(normalMatrix * glm::vec3(vertex[3], vertex[4], vertex[5]));
+                vertex[3] = normal.x;
+                vertex[4] = normal.y;
+                vertex[5] = normal.z;
+            }
+            low = v == 0 ? position : glm::min(low, position);
+            high = v == 0 ? position : glm::max(high, position);
+        }
+        object.center = (low + high) * 0.5f;
+        objects.push_back(object);
+    }
+
+    // merges and uploads everything added; the objects themselves are dropped, the merged geometry kept
+    // for mesh()
+    void build(float chunkSize = DEFAULT_CHUNK_SIZE, const VertexFormat& format = VertexFormat())
+    {
+        for (size_t i = 0; i < objects.size(); i++) {
+            glm::vec3 cell = glm::floor(objects[i].center / chunkSize);
+            objects[i].cell = glm::ivec3(cell);
+        }
+        std::sort(objects.begin(), objects.end(), [](const Object& a, const Object& b) {
+            if (a.material != b.material) {
+                return a.material < b.material;
+            }
+            if (a.cell.x != b.cell.x) {
+                return a.cell.x < b.cell.x;
+            }
+            if (a.cell.y != b.cell.y) {
+                return a.cell.y < b.cell.y;
+            }
+            return a.cell.z < b.cell.z;
+        });
+
+        Mesh& merged = geometry;
+        merged = Mesh();
+        merged.floatsPerVertex = floatsPerVertex;
+        chunks.clear();
+        for (size_t i = 0; i < objects.size(); i++) {
+            const Object& object = objects[i];
+            if (i == 0 || object.material != objects[i - 1].material || object.cell != objects[i - 1].cell) {
+                Chunk chunk;
+                chunk.material = object.material;
+                chunk.firstIndex = merged.indices.size();
+                chunk.firstVertex = merged.vertexCount();
+                chunks.push_back(chunk);
+            }
+            unsigned int base = (unsigned int)merged.vertexCount();
+            merged.vertices.insert(merged.vertices.end(), object.vertices.begin(), object.vertices.end());
+            for (size_t j = 0; j < object.indices.size(); j++) {
+                merged.indices.push_back(base + object.indices[j]);
+            }
+        }
+        for (size_t i = 0; i < chunks.size(); i++) {
+            size_t endIndex = i + 1 < chunks.size() ? chunks[i + 1].firstIndex : merged.indices.size();
+            size_t endVertex = i + 1 < chunks.size() ? chunks[i + 1].firstVertex : merged.vertexCount();
+            chunks[i].count = (GLsizei)(endIndex - chunks[i].firstIndex);
+            chunks[i].sphere = chunkSphere(merged, chunks[i].firstVertex, endVertex);
+        }
+        objectCount = objects.size();
+        objects.clear();
+        buffer.upload(merged, format);
+    }
+
+    unsigned int createVertexArray(unsigned int attributes) { return buffer.createVertexArray(attributes); }
+    std::string shaderDecode() const { return buffer.shaderDecode(); }
+    unsigned int vertexBase() const { return buffer.vertexBase(); }
+
+    // draws the chunks of `material` that intersect the frustum; returns how many draws that took
+    unsigned int draw(unsigned int vao, unsigned int material, const glm::mat4& viewProjection)
+    {
+        glm::vec4 planes[6];
+        frustumPlanes(viewProjection, planes);
+        glBindVertexArray(vao);
+        InstancedRenderer::setConstantInstance(glm::mat4(1.0f), material);
+
+        unsigned int draws = 0;
+        size_t indexSize = buffer.indexType() == GL_UNSIGNED_SHORT ? 2 : 4;
+        size_t runStart = 0;
+        GLsizei runCount = 0;
+        for (size_t i = 0; i <= chunks.size(); i++) {
+            bool visible = i < chunks.size() && chunks[i].material == material && sphereInFrustum(planes, chunks[i].sphere);
+            if (visible && runCount > 0) {
+                runCount += chunks[i].count;
+                continue;
+            }
+            // the run ends here; chunks are contiguous in the index buffer, so one draw covers it
+            if (runCount > 0) {
+                glDrawElements(GL_TRIANGLES, runCount, buffer.indexType(), (void*)(buffer.indexOffset() + runStart * indexSize));
+                draws++;
+                runCount = 0;
+            }
+            if (visible) {
+                runStart = chunks[i].firstIndex;
+                runCount = chunks[i].count;
+            }
+        }
+        return draws;
+    }
+
+    // the merged world-space geometry as uploaded, e.g. for LightmapBaker; vertices in buffer order
+    const Mesh& mesh() const { return geometry; }
+    size_t size() const { return objectCount; }
+    size_t chunkCount() const { return chunks.size(); }
+
+    void destroy()
+    {
+        buffer.destroy();
+        chunks.clear();
+        objects.clear();
+        geometry = Mesh();
+        floatsPerVertex = 0;
+    }
+
+private:
+    struct Object {
+        unsigned int material;
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        glm::vec3 center;
+        glm::ivec3 cell;
+    };
+
+    struct Chunk {
+        unsigned int material = 0;
+        size_t firstIndex = 0;
+        size_t firstVertex = 0;
+        GLsizei count = 0;
+        glm::vec4 sphere = glm::vec4(0.0f);
+    };
+
+    static glm::vec4 chunkSphere(const Mesh& mesh, size_t first, size_t end)
+    {
+        Mesh part;
+        part.floatsPerVertex = mesh.floatsPerVertex;
+        part.vertices.assign(mesh.vertices.begin() + first * mesh.floatsPerVertex, mesh.vertices.begin() + end * mesh.floatsPerVertex);
+        return boundingSphere(part);
+    }
+
+    std::vector<Object> objects;
+    std::vector<Chunk> chunks;
+    Mesh geometry;
+    MeshBuffer buffer;
+    unsigned int floatsPerVertex = 0;
+    size_t objectCount = 0;
+};
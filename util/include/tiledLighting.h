@@ -0,0 +1,249 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <clusteredLighting.h>
+#include <lighting.h>
+#include <shader.h>
+
+#include <iostream>
+#include <string>
+
+// Forward+ (tiled forward) shading. A depth prepass renders into depthFramebuffer; a compute shader
+// then takes each TILE_SIZE x TILE_SIZE pixel tile's min / max depth and lists the lights whose range
+// sphere reaches into the tile's frustum between the two. The lists have the layout of
+// ClusteredLighting's, a grid of one depth slice, so the same fragment lookup reads either.
+//
+//     tiles.resize(width, height);
+//     glBindFramebuffer(GL_FRAMEBUFFER, tiles.depthFramebuffer);   // depth-only pass of the opaque geometry
+//     tiles.assign(view, projection, lightCount);                 // lights bound at POINT_LIGHTS_BINDING
+//     tiles.setUniforms(shader);
+//
+// Compared with clusters the lists cost a prepass, but they only hold lights near visible surfaces.
+class TiledLighting
+{
+public:
+    static const unsigned int TILE_SIZE = 16;
+    // lights past this many in one tile are dropped
+    static const unsigned int MAX_LIGHTS_PER_TILE = 256;
+
+    void init()
+    {
+        assignProgram = compileAssignProgram();
+        glProgramUniform1i(assignProgram, glGetUniformLocation(assignProgram, "depth"), 0);
+    }
+
+    // (re)creates the depth target and the lists for a `width` x `height` framebuffer
+    void resize(unsigned int newWidth, unsigned int newHeight)
+    {
+        if (depthFramebuffer != 0 && newWidth == width && newHeight == height) {
+            return;
+        }
+        destroyTargets();
+        width = newWidth;
+        height = newHeight;
+        tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+        glGenTextures(1, &depthTexture);
+        glBindTexture(GL_TEXTURE_2D, depthTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glGenFramebuffers(1, &depthFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, depthFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::TILED_LIGHTING:: Depth framebuffer is not complete" << std::endl;
+        }
+
+        glGenBuffers(1, &gridBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, gridBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tilesX * tilesY * 2 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+        glGenBuffers(1, &indexBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tilesX * tilesY * MAX_LIGHTS_PER_TILE * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+    }
+
+    // lists, per tile, the `lightCount` lights bound at POINT_LIGHTS_BINDING against the prepass depth
+    void assign(const glm::mat4& view, const glm::mat4& projection, unsigned int lightCount)
+    {
+        nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+        farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+
+        glUseProgram(assignProgram);
+        glm::mat4 inverseProjection = glm::inverse(projection);
+        glUniformMatrix4fv(glGetUniformLocation(assignProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(assignProgram, "inverseProjection"), 1, GL_FALSE, glm::value_ptr(inverseProjection));
+        glUniform2f(glGetUniformLocation(assignProgram, "depthRange"), nearPlane, farPlane);
+        glUniform2ui(glGetUniformLocation(assignProgram, "screenSize"), width, height);
+        glUniform1ui(glGetUniformLocation(assignProgram, "lightCount"), lightCount);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, depthTexture);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_GRID_BINDING, gridBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_BINDING, indexBuffer);
+        glDispatchCompute(tilesX, tilesY, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    // the lookup uniforms of a shader that reads the lists, see ClusteredLighting::setUniforms
+    void setUniforms(unsigned int program) const
+    {
+        glProgramUniform3ui(program, glGetUniformLocation(program, "clusterGrid"), tilesX, tilesY, 1);
+        glProgramUniform2f(program, glGetUniformLocation(program, "clusterScale"), 1.0f / TILE_SIZE, 1.0f / TILE_SIZE);
+        // one slice: the slice scale is zero
+        glProgramUniform3f(program, glGetUniformLocation(program, "clusterDepth"), nearPlane, farPlane, 0.0f);
+    }
+
+    void destroy()
+    {
+        destroyTargets();
+        glDeleteProgram(assignProgram);
+        assignProgram = 0;
+    }
+
+    unsigned int depthFramebuffer = 0;
+
+private:
+    static const unsigned int WORKGROUP_SIZE = TILE_SIZE * TILE_SIZE;
+
+    void destroyTargets()
+    {
+        if (depthFramebuffer == 0) {
+            return;
+        }
+        glDeleteFramebuffers(1, &depthFramebuffer);
+        glDeleteTextures(1, &depthTexture);
+        unsigned int buffers[] = { gridBuffer, indexBuffer };
+        glDeleteBuffers(2, buffers);
+        depthFramebuffer = depthTexture = gridBuffer = indexBuffer = 0;
+    }
+
+    static unsigned int compileAssignProgram()
+    {
+        std::string source = std::string("#version 430 core\n")
+            + "const uint TILE_SIZE = " + std::to_string(TILE_SIZE) + "u;\n"
+            + "const uint GROUP = " + std::to_string(WORKGROUP_SIZE) + "u;\n"
+            + "const uint MAX_LIGHTS = " + std::to_string(MAX_LIGHTS_PER_TILE) + "u;\n"
+            + "layout (local_size_x = " + std::to_string(TILE_SIZE) + ", local_size_y = " + std::to_string(TILE_SIZE) + ") in;\n"
+            + "layout (std430, binding = " + std::to_string(POINT_LIGHTS_BINDING) + ") readonly buffer PointLights { vec4 pointLights[]; };\n"
+            + "layout (std430, binding = " + std::to_string(LIGHT_GRID_BINDING) + ") writeonly buffer LightGrid { uvec2 lightGrid[]; };\n"
+            + "layout (std430, binding = " + std::to_string(LIGHT_INDEX_BINDING) + ") writeonly buffer LightIndices { uint lightIndices[]; };\n"
+            + R"(
+uniform sampler2D depth;
+uniform mat4 view;
+uniform mat4 inverseProjection;
+uniform vec2 depthRange;
+uniform uvec2 screenSize;
+uniform uint lightCount;
+
+shared uint minDepthBits;
+shared uint maxDepthBits;
+shared uint listed;
+// inclusive prefix sum of the hits of the batch being tested
+shared uint hits[GROUP];
+
+// the view-space point of the near plane under window position `window`
+vec3 nearPoint(vec2 window)
+{
+    vec4 p = inverseProjection * vec4(window / vec2(screenSize) * 2.0 - 1.0, -1.0, 1.0);
+    return p.xyz / p.w;
+}
+
+float viewDepth(float z)
+{
+    return depthRange.x * depthRange.y / (depthRange.y - z * (depthRange.y - depthRange.x));
+}
+
+void main()
+{
+    uint local = gl_LocalInvocationIndex;
+    if (local == 0u) {
+        minDepthBits = 0xFFFFFFFFu;
+        maxDepthBits = 0u;
+        listed = 0u;
+    }
+    barrier();
+
+    // depth bounds of what the prepass left in the tile; depths in [0, 1] order like their bits
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (pixel.x < int(screenSize.x) && pixel.y < int(screenSize.y)) {
+        float z = texelFetch(depth, pixel, 0).r;
+        if (z < 1.0) {
+            atomicMin(minDepthBits, floatBitsToUint(z));
+            atomicMax(maxDepthBits, floatBitsToUint(z));
+        }
+    }
+    barrier();
+    bool covered = minDepthBits <= maxDepthBits;
+    float nearDepth = viewDepth(uintBitsToFloat(minDepthBits));
+    float farDepth = viewDepth(uintBitsToFloat(maxDepthBits));
+
+    // the tile's four side planes, through the eye, normals pointing in
+    vec2 low = vec2(gl_WorkGroupID.xy * TILE_SIZE);
+    vec2 high = min(low + vec2(TILE_SIZE), vec2(screenSize));
+    vec3 corners[4] = vec3[4](nearPoint(low), nearPoint(vec2(high.x, low.y)), nearPoint(high), nearPoint(vec2(low.x, high.y)));
+    vec3 center = nearPoint((low + high) * 0.5);
+    vec3 planes[4];
+    for (int i = 0; i < 4; i++) {
+        vec3 n = normalize(cross(corners[i], corners[(i + 1) & 3]));
+        planes[i] = dot(n, center) < 0.0 ? -n : n;
+    }
+
+    uint tile = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    uint first = tile * MAX_LIGHTS;
+    for (uint batch = 0u; covered && batch < lightCount; batch += GROUP) {
+        uint light = batch + local;
+        bool hit = light < lightCount;
+        if (hit) {
+            vec4 sphere = pointLights[light * 4u];
+            vec3 position = vec3(view * vec4(sphere.xyz, 1.0));
+            hit = -position.z + sphere.w >= nearDepth && -position.z - sphere.w <= farDepth;
+            for (int i = 0; i < 4; i++) {
+                hit = hit && dot(planes[i], position) >= -sphere.w;
+            }
+        }
+
+        // the hits keep their order in the list, so tiles sum their lights like the forward path
+        hits[local] = hit ? 1u : 0u;
+        barrier();
+        for (uint offset = 1u; offset < GROUP; offset <<= 1) {
+            uint add = local >= offset ? hits[local - offset] : 0u;
+            barrier();
+            hits[local] += add;
+            barrier();
+        }
+        uint slot = listed + hits[local] - 1u;
+        if (hit && slot < MAX_LIGHTS) {
+            lightIndices[first + slot] = light;
+        }
+        barrier();
+        if (local == GROUP - 1u) {
+            listed += hits[local];
+        }
+        barrier();
+    }
+    if (local == 0u) {
+        lightGrid[tile] = uvec2(first, min(listed, MAX_LIGHTS));
+    }
+}
+)";
+        return compileComputeProgram(source);
+    }
+
+    unsigned int assignProgram = 0;
+    unsigned int depthTexture = 0;
+    unsigned int gridBuffer = 0;
+    unsigned int indexBuffer = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int tilesX = 0;
+    unsigned int tilesY = 0;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+};
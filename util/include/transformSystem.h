@@ -0,0 +1,244 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <float4.h>
+#include <frameLoop.h>
+#include <instancedRenderer.h>
+#include <parallel.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define TRANSFORM_AVX2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC compiles AVX2 intrinsics without /arch:AVX2; the caller checks the CPU first
+#define TRANSFORM_AVX2_TARGET
+#else
+#define TRANSFORM_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+// true when the CPU (and the OS, for the YMM registers' state) can run AVX2 code
+inline bool cpuHasAVX2()
+{
+#if defined(TRANSFORM_AVX2) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(TRANSFORM_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// Object transforms kept as structure of arrays (position, rotation quaternion and scale, one array
+// per component), composed into InstanceData for every object in one pass:
+//
+//     model        = translate(position) * mat4_cast(rotation) * scale(scale)
+//     normalMatrix = rotation * scale^-1, the inverse transpose of mat3(model) without inverting
+//
+// eight objects at a time with AVX2 where the CPU has it, four with Float4 otherwise, and above
+// PARALLEL_THRESHOLD objects spread over the cores. write() goes straight to where the instances
+// are drawn from, e.g. InstancedRenderer::map's persistently mapped ring memory:
+//
+//     unsigned int cube = transforms.add(transform);     // at load
+//     transforms.set(cube, transform);                   // whenever it moves
+//     transforms.write(cubeInstances.map(transforms.size()));
+//     cubeInstances.drawElements(...);
+class TransformSystem
+{
+public:
+    // objects a thread takes at a time, and the count below which one thread does them all
+    static const size_t GRAIN = 1024;
+    static const size_t PARALLEL_THRESHOLD = 4 * GRAIN;
+
+    TransformSystem() : avx2(cpuHasAVX2()) {}
+
+    // returns the object's index
+    unsigned int add(const Transform& transform, unsigned int material = 0)
+    {
+        unsigned int index = (unsigned int)count;
+        count++;
+        // the arrays stay padded to whole AVX2 batches with identity transforms
+        if (px.size() < count) {
+            size_t padded = (count + 7) & ~(size_t)7;
+            for (std::vector<float>* a : { &px, &py, &pz, &qx, &qy, &qz }) {
+                a->resize(padded, 0.0f);
+            }
+            for (std::vector<float>* a : { &qw, &sx, &sy, &sz }) {
+                a->resize(padded, 1.0f);
+            }
+            materials.resize(padded, 0);
+        }
+        set(index, transform);
+        materials[index] = material;
+        return index;
+    }
+
+    void set(unsigned int i, const Transform& transform)
+    {
+        setPosition(i, transform.position);
+        setRotation(i, transform.rotation);
+        sx[i] = transform.scale.x;
+        sy[i] = transform.scale.y;
+        sz[i] = transform.scale.z;
+    }
+
+    void setPosition(unsigned int i, const glm::vec3& position)
+    {
+        px[i] = position.x;
+        py[i] = position.y;
+        pz[i] = position.z;
+    }
+
+    // `rotation` must be normalized
+    void setRotation(unsigned int i, const glm::quat& rotation)
+    {
+        qx[i] = rotation.x;
+        qy[i] = rotation.y;
+        qz[i] = rotation.z;
+        qw[i] = rotation.w;
+    }
+
+    void clear()
+    {
+        count = 0;
+        for (std::vector<float>* a : { &px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz }) {
+            a->clear();
+        }
+        materials.clear();
+    }
+
+    size_t size() const { return count; }
+    bool usesAVX2() const { return avx2; }
+
+    // the InstanceData of every object, in index order, into `out` (size() of them); `threads` 0 is
+    // every core once there are PARALLEL_THRESHOLD objects
+    void write(InstanceData* out, unsigned int threads = 0) const
+    {
+        if (count == 0) {
+            return;
+        }
+        if (threads == 0) {
+            threads = count >= PARALLEL_THRESHOLD ? workerThreads() : 1;
+        }
+        parallelFor((count + GRAIN - 1) / GRAIN, 1, threads, [&](size_t block) {
+            size_t first = block * GRAIN;
+            size_t end = std::min(count, first + GRAIN);
+#ifdef TRANSFORM_AVX2
+            if (avx2) {
+                composeAVX2(first, end, out);
+                return;
+            }
+#endif
+            composeFloat4(first, end, out);
+        });
+    }
+
+private:
+    // a batch's results, component-major: 9 of mat3(model), then 9 of the normal matrix, both
+    // column-major, one float per object of the batch
+    static const unsigned int COMPONENTS = 18;
+
+    // objects [first, end) from batches of four; end may cut the last batch short
+    void composeFloat4(size_t first, size_t end, InstanceData* out) const
+    {
+        float lanes[COMPONENTS][8];
+        for (size_t i = first; i < end; i += 4) {
+            Float4 x = Float4::load(&qx[i]), y = Float4::load(&qy[i]), z = Float4::load(&qz[i]), w = Float4::load(&qw[i]);
+            Float4 one(1.0f), two(2.0f);
+            Float4 xx = x * x, yy = y * y, zz = z * z;
+            Float4 xy = x * y, xz = x * z, yz = y * z;
+            Float4 wx = w * x, wy = w * y, wz = w * z;
+            Float4 r[9] = {
+                one - two * (yy + zz), two * (xy + wz), two * (xz - wy),
+                two * (xy - wz), one - two * (xx + zz), two * (yz + wx),
+                two * (xz + wy), two * (yz - wx), one - two * (xx + yy)
+            };
+            Float4 scale[3] = { Float4::load(&sx[i]), Float4::load(&sy[i]), Float4::load(&sz[i]) };
+            for (unsigned int c = 0; c < 3; c++) {
+                Float4 inverse = one / scale[c];
+                for (unsigned int row = 0; row < 3; row++) {
+                    (r[c * 3 + row] * scale[c]).store(lanes[c * 3 + row]);
+                    (r[c * 3 + row] * inverse).store(lanes[9 + c * 3 + row]);
+                }
+            }
+            scatter(lanes, i, std::min(end, i + 4), out);
+        }
+    }
+
+#ifdef TRANSFORM_AVX2
+    // composeFloat4 eight objects at a time
+    TRANSFORM_AVX2_TARGET void composeAVX2(size_t first, size_t end, InstanceData* out) const
+    {
+        float lanes[COMPONENTS][8];
+        for (size_t i = first; i < end; i += 8) {
+            __m256 x = _mm256_loadu_ps(&qx[i]), y = _mm256_loadu_ps(&qy[i]), z = _mm256_loadu_ps(&qz[i]), w = _mm256_loadu_ps(&qw[i]);
+            __m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f);
+            __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+            __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+            __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+            __m256 r[9] = {
+                _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))),
+                _mm256_mul_ps(two, _mm256_add_ps(xy, wz)),
+                _mm256_mul_ps(two, _mm256_sub_ps(xz, wy)),
+                _mm256_mul_ps(two, _mm256_sub_ps(xy, wz)),
+                _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))),
+                _mm256_mul_ps(two, _mm256_add_ps(yz, wx)),
+                _mm256_mul_ps(two, _mm256_add_ps(xz, wy)),
+                _mm256_mul_ps(two, _mm256_sub_ps(yz, wx)),
+                _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy)))
+            };
+            __m256 scale[3] = { _mm256_loadu_ps(&sx[i]), _mm256_loadu_ps(&sy[i]), _mm256_loadu_ps(&sz[i]) };
+            for (unsigned int c = 0; c < 3; c++) {
+                __m256 inverse = _mm256_div_ps(one, scale[c]);
+                for (unsigned int row = 0; row < 3; row++) {
+                    _mm256_storeu_ps(lanes[c * 3 + row], _mm256_mul_ps(r[c * 3 + row], scale[c]));
+                    _mm256_storeu_ps(lanes[9 + c * 3 + row], _mm256_mul_ps(r[c * 3 + row], inverse));
+                }
+            }
+            scatter(lanes, i, std::min(end, i + 8), out);
+        }
+    }
+#endif
+
+    // objects [first, end) of a batch from its lanes into InstanceData, written front to back so
+    // write-combined mapped memory sees whole lines
+    void scatter(const float lanes[COMPONENTS][8], size_t first, size_t end, InstanceData* out) const
+    {
+        for (size_t i = first; i < end; i++) {
+            size_t lane = i - first;
+            InstanceData& instance = out[i];
+            for (unsigned int c = 0; c < 3; c++) {
+                instance.model[c] = glm::vec4(lanes[c * 3][lane], lanes[c * 3 + 1][lane], lanes[c * 3 + 2][lane], 0.0f);
+            }
+            instance.model[3] = glm::vec4(px[i], py[i], pz[i], 1.0f);
+            for (unsigned int c = 0; c < 3; c++) {
+                instance.normalMatrix[c] = glm::vec3(lanes[9 + c * 3][lane], lanes[9 + c * 3 + 1][lane], lanes[9 + c * 3 + 2][lane]);
+            }
+            instance.material = materials[i];
+        }
+    }
+
+    size_t count = 0;
+    std::vector<float> px, py, pz;
+    std::vector<float> qx, qy, qz, qw;
+    std::vector<float> sx, sy, sz;
+    std::vector<unsigned int> materials;
+    bool avx2;
+};
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// How each vertex attribute is stored in the vertex buffer.
+//   POSITION_HALF          4 half floats (w is padding), no decode
+//   POSITION_SNORM16       4 normalized shorts over the mesh bounds, decoded with a scale and bias
+//   NORMAL_INT_2_10_10_10  GL_INT_2_10_10_10_REV, normalized by the vertex fetch
+//   NORMAL_OCTAHEDRAL      2 normalized shorts, the unit sphere folded onto a square
+//   TEXCOORD_UNORM16       2 normalized unsigned shorts over the mesh's uv bounds
+enum PositionFormat { POSITION_FLOAT, POSITION_HALF, POSITION_SNORM16 };
+enum NormalFormat { NORMAL_FLOAT, NORMAL_INT_2_10_10_10, NORMAL_OCTAHEDRAL };
+enum TexCoordFormat { TEXCOORD_FLOAT, TEXCOORD_UNORM16 };
+
+// the defaults pack position / normal / uv into 16 bytes instead of 32
+struct VertexFormat {
+    PositionFormat position = POSITION_SNORM16;
+    NormalFormat normal = NORMAL_INT_2_10_10_10;
+    TexCoordFormat texCoord = TEXCOORD_UNORM16;
+
+    static VertexFormat uncompressed()
+    {
+        VertexFormat format;
+        format.position = POSITION_FLOAT;
+        format.normal = NORMAL_FLOAT;
+        format.texCoord = TEXCOORD_FLOAT;
+        return format;
+    }
+};
+
+// attributes a VAO reads, see VertexLayout::setAttributes
+enum VertexAttribute { VERTEX_POSITION = 1, VERTEX_NORMAL = 2, VERTEX_TEXCOORD = 4 };
+
+// storage buffer bindings vertex shaders pull their vertices and the meshes' PulledMesh records from
+// (see VertexLayout::shaderDecode)
+const unsigned int VERTEX_PULL_BINDING = 7;
+const unsigned int VERTEX_PULL_MESHES_BINDING = 8;
+
+// std430 record of a pulled mesh's dequantization ranges, one per mesh in the pool
+struct PulledMesh {
+    glm::vec4 positionScale;
+    glm::vec4 positionBias;
+    // xy scale, zw bias
+    glm::vec4 texCoordScaleBias;
+};
+
+// Where the packed attributes sit in a vertex and how to turn them back into floats.
+// Source vertices are floats laid out as position (3), then normal (3) and uv (2) when present:
+// 3 floats per vertex is position only, 5 position + uv, 6 position + normal, 8 all three.
+struct VertexLayout {
+    VertexFormat format;
+    unsigned int attributes = 0;
+    unsigned int stride = 0;
+    unsigned int normalOffset = 0;
+    unsigned int texCoordOffset = 0;
+    // decoded = packed * scale + bias, after the vertex fetch has normalized the packed value
+    glm::vec3 positionScale = glm::vec3(1.0f);
+    glm::vec3 positionBias = glm::vec3(0.0f);
+    glm::vec2 texCoordScale = glm::vec2(1.0f);
+    glm::vec2 texCoordBias = glm::vec2(0.0f);
+
+    VertexLayout() {}
+
+    VertexLayout(const VertexFormat& format, unsigned int floatsPerVertex) : format(format)
+    {
+        attributes = VERTEX_POSITION;
+        if (floatsPerVertex == 6 || floatsPerVertex == 8) {
+            attributes |= VERTEX_NORMAL;
+        }
+        if (floatsPerVertex == 5 || floatsPerVertex == 8) {
+            attributes |= VERTEX_TEXCOORD;
+        }
+        // every attribute starts on a 4 byte boundary, the vertex fetch is slower otherwise
+        stride = format.position == POSITION_FLOAT ? 12 : 8;
+        if (attributes & VERTEX_NORMAL) {
+            normalOffset = stride;
+            stride += format.normal == NORMAL_FLOAT ? 12 : 4;
+        }
+        if (attributes & VERTEX_TEXCOORD) {
+            texCoordOffset = stride;
+            stride += format.texCoord == TEXCOORD_FLOAT ? 8 : 4;
+        }
+    }
+
+    // Points attribute locations 0, 1, ... of the bound VAO at the requested attributes of the bound
+    // GL_ARRAY_BUFFER, in position, normal, uv order. Shaders declare them as
+    //   in vec3 aPos;  in vec3 aNormal;  in vec2 aTexCoord;
+    // whatever the format, and read them through the functions in shaderDecode(). The vertices start
+    // `base` bytes into the buffer.
+    void setAttributes(unsigned int requested, size_t base = 0) const
+    {
+        unsigned int location = 0;
+        if (requested & VERTEX_POSITION) {
+            switch (format.position) {
+            case POSITION_FLOAT:
+                glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (void*)base);
+                break;
+            case POSITION_HALF:
+                glVertexAttribPointer(location, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)base);
+                break;
+            case POSITION_SNORM16:
+                glVertexAttribPointer(location, 3, GL_SHORT, GL_TRUE, stride, (void*)base);
+                break;
+            }
+            glEnableVertexAttribArray(location++);
+        }
+        if ((requested & VERTEX_NORMAL) && (attributes & VERTEX_NORMAL)) {
+            switch (format.normal) {
+            case NORMAL_FLOAT:
+                glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + normalOffset));
+                break;
+            case NORMAL_INT_2_10_10_10:
+                // GL_INT_2_10_10_10_REV only comes in size 4 (or GL_BGRA); the shader ignores w
+                glVertexAttribPointer(location, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)(base + normalOffset));
+                break;
+            case NORMAL_OCTAHEDRAL:
+                glVertexAttribPointer(location, 2, GL_SHORT, GL_TRUE, stride, (void*)(base + normalOffset));
+                break;
+            }
+            glEnableVertexAttribArray(location++);
+        }
+        if ((requested & VERTEX_TEXCOORD) && (attributes & VERTEX_TEXCOORD)) {
+            if (format.texCoord == TEXCOORD_FLOAT) {
+                glVertexAttribPointer(location, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + texCoordOffset));
+            } else {
+                glVertexAttribPointer(location, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)(base + texCoordOffset));
+            }
+            glEnableVertexAttribArray(location++);
+        }
+    }
+
+    // the ranges as the pool's record of the mesh holds them
+    PulledMesh pulledMesh() const
+    {
+        PulledMesh mesh;
+        mesh.positionScale = glm::vec4(positionScale, 0.0f);
+        mesh.positionBias = glm::vec4(positionBias, 0.0f);
+        mesh.texCoordScaleBias = glm::vec4(texCoordScale, texCoordBias);
+        return mesh;
+    }
+
+    // GLSL for the vertex shader, inserted after its #version line (see Shader):
+    //   vec3 decodePosition(vec3 aPos);  vec3 decodeNormal(vec3 aNormal);  vec2 decodeTexCoord(vec2 aTexCoord);
+    // the dequantization ranges are baked in as constants.
+    //
+    // With `pull`, the functions ignore their argument and pull the vertex out of the storage buffer at
+    // VERTEX_PULL_BINDING instead, at word gl_VertexID * stride / 4 (the indices count from the start
+    // of the pool); the shader keeps declaring its attributes, they just aren't read. The ranges come
+    // from the PulledMesh at VERTEX_PULL_MESHES_BINDING whose index the pool left in the position's
+    // padding, so the code depends on the format alone and every mesh of that format shares a program.
+    std::string shaderDecode(bool pull = false) const
+    {
+        std::ostringstream glsl;
+        glsl.precision(9);
+        glsl << std::showpoint;
+        if (pull) {
+            glsl << "layout (std430, binding = " << VERTEX_PULL_BINDING << ") readonly buffer PulledVertices { uint pulledVertices[]; };\n"
+                << "struct PulledMesh { vec4 positionScale; vec4 positionBias; vec4 texCoordScaleBias; };\n"
+                << "layout (std430, binding = " << VERTEX_PULL_MESHES_BINDING << ") readonly buffer PulledMeshes { PulledMesh pulledMeshes[]; };\n"
+                << "uint pulledVertex(uint offset)\n{\n"
+                << "    return pulledVertices[uint(gl_VertexID) * " << stride / 4 << "u + offset];\n"
+                << "}\n"
+                << "PulledMesh pulledMesh()\n{\n"
+                << "    return pulledMeshes[pulledVertex(1u) >> 16u];\n"
+                << "}\n";
+        }
+
+        glsl << "vec3 decodePosition(vec3 p)\n{\n";
+        if (pull) {
+            const char* unpack = format.position == POSITION_HALF ? "unpackHalf2x16" : "unpackSnorm2x16";
+            glsl << "    p = " << pullVec3(format.position == POSITION_FLOAT ? NULL : unpack, 0) << ";\n";
+        }
+        if (format.position == POSITION_SNORM16 && pull) {
+            glsl << "    PulledMesh mesh = pulledMesh();\n"
+                << "    return p * mesh.positionScale.xyz + mesh.positionBias.xyz;\n";
+        } else if (format.position == POSITION_SNORM16) {
+            glsl << "    return p * vec3(" << positionScale.x << ", " << positionScale.y << ", " << positionScale.z << ")"
+                << " + vec3(" << positionBias.x << ", " << positionBias.y << ", " << positionBias.z << ");\n";
+        } else {
+            glsl << "    return p;\n";
+        }
+        glsl << "}\n";
+
+        glsl << "vec3 decodeNormal(vec3 n)\n{\n";
+        if (pull && (attributes & VERTEX_NORMAL)) {
+            unsigned int word = normalOffset / 4;
+            if (format.normal == NORMAL_FLOAT) {
+                glsl << "    n = " << pullVec3(NULL, word) << ";\n";
+            } else if (format.normal == NORMAL_INT_2_10_10_10) {
+                // what the fixed-function fetch of GL_INT_2_10_10_10_REV does: sign-extend, scale, clamp
+                glsl << "    int w = int(pulledVertex(" << word << "u));\n"
+                    << "    n = max(vec3(bitfieldExtract(w, 0, 10), bitfieldExtract(w, 10, 10), bitfieldExtract(w, 20, 10)) / 511.0, -1.0);\n";
+            } else {
+                glsl << "    n = vec3(unpackSnorm2x16(pulledVertex(" << word << "u)), 0.0);\n";
+            }
+        }
+        if (format.normal == NORMAL_OCTAHEDRAL) {
+            // unfold the lower hemisphere from the square's corners
+            glsl << "    vec3 v = vec3(n.xy, 1.0 - abs(n.x) - abs(n.y));\n"
+                << "    float t = max(-v.z, 0.0);\n"
+                << "    v.xy += vec2(v.x >= 0.0 ? -t : t, v.y >= 0.0 ? -t : t);\n"
+                << "    return normalize(v);\n";
+        } else {
+            glsl << "    return n;\n";
+        }
+        glsl << "}\n";
+
+        glsl << "vec2 decodeTexCoord(vec2 t)\n{\n";
+        if (pull && (attributes & VERTEX_TEXCOORD)) {
+            unsigned int word = texCoordOffset / 4;
+            if (format.texCoord == TEXCOORD_FLOAT) {
+                glsl << "    t = vec2(uintBitsToFloat(pulledVertex(" << word << "u)), uintBitsToFloat(pulledVertex(" << word + 1 << "u)));\n";
+            } else {
+                glsl << "    t = unpackUnorm2x16(pulledVertex(" << word << "u));\n";
+            }
+        }
+        if (format.texCoord == TEXCOORD_UNORM16 && pull) {
+            glsl << "    vec4 scaleBias = pulledMesh().texCoordScaleBias;\n"
+                << "    return t * scaleBias.xy + scaleBias.zw;\n";
+        } else if (format.texCoord == TEXCOORD_UNORM16) {
+            glsl << "    return t * vec2(" << texCoordScale.x << ", " << texCoordScale.y << ")"
+                << " + vec2(" << texCoordBias.x << ", " << texCoordBias.y << ");\n";
+        } else {
+            glsl << "    return t;\n";
+        }
+        glsl << "}\n";
+        return glsl.str();
+    }
+
+private:
+    // three floats starting at `word`, or three 16 bit values with the unpack function for their type
+    static std::string pullVec3(const char* unpack, unsigned int word)
+    {
+        std::ostringstream glsl;
+        if (unpack == NULL) {
+            glsl << "vec3(uintBitsToFloat(pulledVertex(" << word << "u)), uintBitsToFloat(pulledVertex(" << word + 1 << "u)), "
+                << "uintBitsToFloat(pulledVertex(" << word + 2 << "u)))";
+        } else {
+            glsl << "vec3(" << unpack << "(pulledVertex(" << word << "u)), " << unpack << "(pulledVertex(" << word + 1 << "u)).x)";
+        }
+        return glsl.str();
+    }
+};
+
+// IEEE half float, rounded to nearest
+inline unsigned short floatToHalf(float value)
+{
+    unsigned int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    unsigned int sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) {
+        // inf stays inf, NaN stays NaN
+        return (unsigned short)(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+    }
+    if (exponent >= 31) {
+        return (unsigned short)(sign | 0x7c00);
+    }
+    if (exponent <= 0) {
+        // too small for a normal half, becomes denormal or zero
+        if (exponent < -10) {
+            return (unsigned short)sign;
+        }
+        mantissa |= 0x800000;
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1) {
+            half++;
+        }
+        return (unsigned short)(sign | half);
+    }
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    // a carry out of the mantissa correctly bumps the exponent
+    if (mantissa & 0x1000) {
+        half++;
+    }
+    return (unsigned short)half;
+}
+
+inline short packSnorm16(float value)
+{
+    return (short)std::lround(std::min(std::max(value, -1.0f), 1.0f) * 32767.0f);
+}
+
+inline unsigned short packUnorm16(float value)
+{
+    return (unsigned short)std::lround(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f);
+}
+
+// three signed 10 bit normalized components, w = 0
+inline unsigned int packInt2101010(const glm::vec3& v)
+{
+    unsigned int packed = 0;
+    for (int i = 0; i < 3; i++) {
+        int component = (int)std::lround(std::min(std::max(v[i], -1.0f), 1.0f) * 511.0f);
+        packed |= ((unsigned int)component & 0x3ff) << (i * 10);
+    }
+    return packed;
+}
+
+// projects a unit vector onto the octahedron |x| + |y| + |z| = 1 and folds the lower half outwards
+inline glm::vec2 encodeOctahedral(const glm::vec3& n)
+{
+    glm::vec3 v = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    glm::vec2 e(v.x, v.y);
+    if (v.z < 0.0f) {
+        e.x = (1.0f - std::abs(v.y)) * (v.x >= 0.0f ? 1.0f : -1.0f);
+        e.y = (1.0f - std::abs(v.x)) * (v.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return e;
+}
+
+// Packs `vertexCount` float vertices into `format`. The returned bytes go straight into a vertex buffer;
+// `layout` receives the offsets and the dequantization ranges the VAO and the shader need.
+inline std::vector<unsigned char> packVertices(const float* vertices, size_t vertexCount, unsigned int floatsPerVertex, const VertexFormat& format, VertexLayout& layout)
+{
+    layout = VertexLayout(format, floatsPerVertex);
+    std::vector<unsigned char> packed(vertexCount * layout.stride, 0);
+    if (vertexCount == 0) {
+        return packed;
+    }
+    unsigned int texCoordSource = (layout.attributes & VERTEX_NORMAL) ? 6 : 3;
+
+    // quantized attributes cover exactly the mesh's range
+    glm::vec3 positionMin(vertices[0], vertices[1], vertices[2]);
+    glm::vec3 positionMax = positionMin;
+    glm::vec2 texCoordMin(0.0f), texCoordMax(0.0f);
+    if (layout.attributes & VERTEX_TEXCOORD) {
+        texCoordMin = texCoordMax = glm::vec2(vertices[texCoordSource], vertices[texCoordSource + 1]);
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* vertex = vertices + v * floatsPerVertex;
+        positionMin = glm::min(positionMin, glm::vec3(vertex[0], vertex[1], vertex[2]));
+        positionMax = glm::max(positionMax, glm::vec3(vertex[0], vertex[1], vertex[2]));
+        if (layout.attributes & VERTEX_TEXCOORD) {
+            texCoordMin = glm::min(texCoordMin, glm::vec2(vertex[texCoordSource], vertex[texCoordSource + 1]));
+            texCoordMax = glm::max(texCoordMax, glm::vec2(vertex[texCoordSource], vertex[texCoordSource + 1]));
+        }
+    }
+    if (format.position == POSITION_SNORM16) {
+        layout.positionBias = (positionMin + positionMax) * 0.5f;
+        // a flat axis would divide by zero
+        layout.positionScale = glm::max((positionMax - positionMin) * 0.5f, glm::vec3(1e-20f));
+    }
+    if (format.texCoord == TEXCOORD_UNORM16 && (layout.attributes & VERTEX_TEXCOORD)) {
+        layout.texCoordBias = texCoordMin;
+        layout.texCoordScale = glm::max(texCoordMax - texCoordMin, glm::vec2(1e-20f));
+    }
+
+    for (size_t v = 0; v < vertexCount; v++) {
+        const float* vertex = vertices + v * floatsPerVertex;
+        unsigned char* out = &packed[v * layout.stride];
+
+        glm::vec3 position(vertex[0], vertex[1], vertex[2]);
+        if (format.position == POSITION_FLOAT) {
+            std::memcpy(out, &position, 12);
+        } else if (format.position == POSITION_HALF) {
+            unsigned short half[4] = { floatToHalf(position.x), floatToHalf(position.y), floatToHalf(position.z), 0 };
+            std::memcpy(out, half, 8);
+        } else {
+            glm::vec3 unit = (position - layout.positionBias) / layout.positionScale;
+            short snorm[4] = { packSnorm16(unit.x), packSnorm16(unit.y), packSnorm16(unit.z), 0 };
+            std::memcpy(out, snorm, 8);
+        }
+
+        if (layout.attributes & VERTEX_NORMAL) {
+            glm::vec3 normal(vertex[3], vertex[4], vertex[5]);
+            unsigned char* target = out + layout.normalOffset;
+            if (format.normal == NORMAL_FLOAT) {
+                std::memcpy(target, &normal, 12);
+            } else if (format.normal == NORMAL_INT_2_10_10_10) {
+                unsigned int word = packInt2101010(normal);
+                std::memcpy(target, &word, 4);
+            } else {
+                glm::vec2 e = encodeOctahedral(normal);
+                short snorm[2] = { packSnorm16(e.x), packSnorm16(e.y) };
+                std::memcpy(target, snorm, 4);
+            }
+        }
+
+        if (layout.attributes & VERTEX_TEXCOORD) {
+            glm::vec2 texCoord(vertex[texCoordSource], vertex[texCoordSource + 1]);
+            unsigned char* target = out + layout.texCoordOffset;
+            if (format.texCoord == TEXCOORD_FLOAT) {
+                std::memcpy(target, &texCoord, 8);
+            } else {
+                glm::vec2 unit = (texCoord - layout.texCoordBias) / layout.texCoordScale;
+                unsigned short unorm[2] = { packUnorm16(unit.x), packUnorm16(unit.y) };
+                std::memcpy(target, unorm, 4);
+            }
+        }
+    }
+    return packed;
+}
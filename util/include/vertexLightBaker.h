@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <float4.h>
+#include <mesh.h>
+#include <parallel.h>
+
+#include <algorithm>
+#include <vector>
+
+// attribute location of the baked colours, past InstancedRenderer's 3..10 and the lightmap's 11
+const unsigned int BAKED_COLOUR_LOCATION = 12;
+
+// Lighting of geometry and a light that never move, evaluated once per vertex on the CPU instead of
+// per vertex every frame: ambient plus Lambert diffuse of one point light, times the object's colour,
+// packed to an RGBA8 colour per vertex. Specular depends on the viewer and is left out. Vertices go
+// through the light four at a time in Float4 lanes, blocks of them spread over the cores.
+//
+//     VertexLightBaker baker;
+//     baker.setLight(position, colour, 0.1f);
+//     std::vector<unsigned int> colours = baker.bake(cubeMesh(), model, objectColour);
+//     buffer = VertexLightBaker::attach(VAO, colours);   // location BAKED_COLOUR_LOCATION
+class VertexLightBaker
+{
+public:
+    // vertices a thread takes at a time, a multiple of 4
+    static const size_t GRAIN = 256;
+
+    void setLight(const glm::vec3& position, const glm::vec3& colour, float ambientStrength)
+    {
+        lightPosition = position;
+        lightColour = colour;
+        ambient = ambientStrength;
+    }
+
+    // one packed colour per vertex of `mesh` (which needs normals), placed by `model`
+    std::vector<unsigned int> bake(const Mesh& mesh, const glm::mat4& model, const glm::vec3& objectColour, unsigned int threads = 0) const
+    {
+        size_t count = mesh.vertexCount();
+        size_t padded = (count + 3) & ~(size_t)3;
+        // world-space positions and normals, structure of arrays so four vertices load as one Float4
+        std::vector<float> px(padded, 0.0f), py(padded, 0.0f), pz(padded, 0.0f);
+        std::vector<float> nx(padded, 0.0f), ny(padded, 0.0f), nz(padded, 1.0f);
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+        bool hasNormal = mesh.floatsPerVertex == 6 || mesh.floatsPerVertex == 8;
+        for (size_t v = 0; v < count; v++) {
+            const float* vertex = &mesh.vertices[v * mesh.floatsPerVertex];
+            glm::vec3 p = glm::vec3(model * glm::vec4(vertex[0], vertex[1], vertex[2], 1.0f));
+            glm::vec3 n = hasNormal ? normalMatrix * glm::vec3(vertex[3], vertex[4], vertex[5]) : glm::vec3(0.0f, 0.0f, 1.0f);
+            px[v] = p.x;
+            py[v] = p.y;
+            pz[v] = p.z;
+            nx[v] = n.x;
+            ny[v] = n.y;
+            nz[v] = n.z;
+        }
+
+        std::vector<unsigned int> colours(padded);
+        glm::vec3 ambientColour = ambient * lightColour * objectColour;
+        glm::vec3 diffuseColour = lightColour * objectColour;
+        size_t blocks = (padded + GRAIN - 1) / GRAIN;
+        parallelFor(blocks, 1, threads != 0 ? threads : workerThreads(), [&](size_t block) {
+            size_t end = std::min(padded, (block + 1) * GRAIN);
+            for (size_t v = block * GRAIN; v < end; v += 4) {
+                Float4 lx = Float4(lightPosition.x) - Float4::load(&px[v]);
+                Float4 ly = Float4(lightPosition.y) - Float4::load(&py[v]);
+                Float4 lz = Float4(lightPosition.z) - Float4::load(&pz[v]);
+                Float4 x = Float4::load(&nx[v]), y = Float4::load(&ny[v]), z = Float4::load(&nz[v]);
+                // dot(normalize(n), normalize(l)), clamped at 0
+                Float4 lengths = sqrt4((lx * lx + ly * ly + lz * lz) * (x * x + y * y + z * z));
+                Float4 diffuse = max4((x * lx + y * ly + z * lz) / max4(lengths, Float4(1e-12f)), Float4(0.0f));
+                float d[4];
+                diffuse.store(d);
+                for (int lane = 0; lane < 4; lane++) {
+                    colours[v + lane] = pack(ambientColour + d[lane] * diffuseColour);
+                }
+            }
+        });
+        colours.resize(count);
+        return colours;
+    }
+
+    // uploads `colours` and points BAKED_COLOUR_LOCATION of `vao` at them, indexed like the mesh's
+    // vertices from its MeshBuffer::vertexBase(), which the buffer leaves unused space for; returns the
+    // buffer, for the caller to delete
+    static unsigned int attach(unsigned int vao, const std::vector<unsigned int>& colours, unsigned int vertexBase = 0)
+    {
+        unsigned int buffer;
+        glGenBuffers(1, &buffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, (vertexBase + colours.size()) * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, vertexBase * sizeof(unsigned int), colours.size() * sizeof(unsigned int), colours.data());
+        glVertexAttribPointer(BAKED_COLOUR_LOCATION, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(unsigned int), (void*)0);
+        glEnableVertexAttribArray(BAKED_COLOUR_LOCATION);
+        glBindVertexArray(0);
+        return buffer;
+    }
+
+private:
+    // RGBA8 as GL reads it from memory: r in the lowest byte
+    static unsigned int pack(const glm::vec3& colour)
+    {
+        glm::vec3 c = glm::clamp(colour, 0.0f, 1.0f) * 255.0f + 0.5f;
+        return (unsigned int)c.r | (unsigned int)c.g << 8 | (unsigned int)c.b << 16 | 0xFF000000u;
+    }
+
+    glm::vec3 lightPosition = glm::vec3(0.0f);
+    glm::vec3 lightColour = glm::vec3(1.0f);
+    float ambient = 0.1f;
+};